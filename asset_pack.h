@@ -0,0 +1,134 @@
+// Asset archive shared by the pack_assets tool and the game.
+//
+// Layout: PackHeader, then entryCount PackEntry records, then the payloads, each
+// starting on a 16-byte boundary. Images are stored as decoded RGBA8 texels in
+// stb_image row order, ready for glTexImage2D; sounds are stored as the original
+// file bytes, since they are handed to an external player.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char PACK_MAGIC[4] = {'I', 'T', 'P', 'K'};
+const uint32_t PACK_VERSION = 1;
+const uint64_t PACK_ALIGNMENT = 16;
+const uint32_t PACK_MAX_IMAGE_SIDE = 16384; // Largest image side accepted, well inside an int
+
+enum PackKind : uint32_t { PACK_RGBA8 = 1, PACK_SOUND = 2 };
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct PackEntry {
+    char name[48];    // File name the asset was packed from, NUL-terminated
+    uint32_t kind;    // PackKind
+    uint32_t width;   // Images only
+    uint32_t height;  // Images only
+    uint32_t reserved;
+    uint64_t offset;  // From the start of the archive
+    uint64_t size;    // Payload bytes
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout");
+static_assert(sizeof(PackEntry) == 80, "PackEntry layout");
+
+// Read-only archive, memory-mapped from a file or embedded in the executable.
+// Views returned by data() point straight into it and stay valid until the
+// pack is closed.
+class AssetPack {
+public:
+    ~AssetPack() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(PackHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file referenced
+        if (mapping == MAP_FAILED) return false;
+        mapped = true;
+        return attach((const unsigned char*)mapping, info.st_size);
+    }
+
+    // Use an archive already in memory (embedded assets); nothing is copied
+    bool openMemory(const unsigned char* data, uint64_t size) {
+        close();
+        if (size < sizeof(PackHeader)) return false;
+        return attach(data, size);
+    }
+
+    void close() {
+        if (base && mapped) munmap((void*)base, length);
+        base = nullptr;
+        length = 0;
+        mapped = false;
+        entries = nullptr;
+        entryCount = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    const PackEntry* find(const char* name) const {
+        for (uint32_t i = 0; i < entryCount; i++) {
+            if (strcmp(entries[i].name, name) == 0) return &entries[i];
+        }
+        return nullptr;
+    }
+
+    const unsigned char* data(const PackEntry& entry) const { return base + entry.offset; }
+
+    // Ask the kernel to start paging an entry in ahead of use
+    void prefetch(const PackEntry& entry) const {
+        if (!mapped) return;
+        uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        uintptr_t start = (uintptr_t)(base + entry.offset) & ~(page - 1);
+        madvise((void*)start, (uintptr_t)(base + entry.offset + entry.size) - start, MADV_WILLNEED);
+    }
+
+private:
+    // Validate the header and every entry's bounds before handing out views
+    bool attach(const unsigned char* data, uint64_t size) {
+        base = data;
+        length = size;
+        const PackHeader* header = (const PackHeader*)base;
+        bool valid = memcmp(header->magic, PACK_MAGIC, 4) == 0 && header->version == PACK_VERSION &&
+                     sizeof(PackHeader) + (uint64_t)header->entryCount * sizeof(PackEntry) <= length;
+        for (uint32_t i = 0; valid && i < header->entryCount; i++) {
+            const PackEntry& entry = ((const PackEntry*)(base + sizeof(PackHeader)))[i];
+            valid = entry.offset <= length && entry.size <= length - entry.offset &&
+                    memchr(entry.name, 0, sizeof(entry.name)) != nullptr;
+            // Texels are uploaded straight from the payload, so it must hold all of them
+            if (valid && entry.kind == PACK_RGBA8) {
+                valid = entry.width > 0 && entry.height > 0 && entry.width <= PACK_MAX_IMAGE_SIDE &&
+                        entry.height <= PACK_MAX_IMAGE_SIDE && (uint64_t)entry.width * entry.height * 4 <= entry.size;
+            }
+        }
+        if (!valid) {
+            close();
+            return false;
+        }
+        entries = (const PackEntry*)(base + sizeof(PackHeader));
+        entryCount = header->entryCount;
+        return true;
+    }
+
+    const unsigned char* base = nullptr;
+    uint64_t length = 0;
+    bool mapped = false;
+    const PackEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+};
@@ -1,8 +1,15 @@
  #ifdef __APPLE__
 #define GL_SILENCE_DEPRECATION
+#define GL_DO_NOT_WARN_IF_MULTI_GL_VERSION_HEADERS_INCLUDED
+#include <OpenGL/gl3.h>
 #include <GLUT/glut.h>
+#include <mach-o/dyld.h>
 #else
+#define GL_GLEXT_PROTOTYPES
 #include <GL/glut.h>
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
 #endif
 #include <iostream>
 #include <vector>
@@ -12,14 +19,746 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <dirent.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "asset_pack.h"
+#include "task_scheduler.h"
+#include "sequence.h"
 
 // Window dimensions
 const int WIDTH = 800;
 const int HEIGHT = 900; // Increased height for more vertical space
 
+// Lava surface: one triangle strip made of the body (floor to surface), a
+// degenerate join, then the wave crest (surface to wave tip), one pair per column
+const int LAVA_COLUMNS = 160; // 5px columns
+const int LAVA_STRIP_VERTICES = (LAVA_COLUMNS + 1) * 4 + 2;
+
+struct LavaStrip {
+    // Static per-vertex data, built once
+    float x[LAVA_STRIP_VERTICES];
+    float kind[LAVA_STRIP_VERTICES];        // 0 = floor, 1 = surface, 2 = wave tip
+    float onSurface[LAVA_STRIP_VERTICES];   // 1 for surface and wave tip vertices
+    float onCrest[LAVA_STRIP_VERTICES];     // 1 for wave tip vertices
+    float crestSin[LAVA_STRIP_VERTICES];    // 5 * sin(0.1 * x) on wave tips, else 0
+    float crestCos[LAVA_STRIP_VERTICES];    // 5 * cos(0.1 * x) on wave tips, else 0
+    unsigned char color[LAVA_STRIP_VERTICES][4];
+    
+    // Filled every frame by the legacy renderer
+    float position[LAVA_STRIP_VERTICES][2];
+} lavaStrip;
+
+void initLavaStrip() {
+    int n = 0;
+    auto add = [&n](float x, int kind, unsigned char r, unsigned char g) {
+        lavaStrip.x[n] = x;
+        lavaStrip.kind[n] = (float)kind;
+        lavaStrip.onSurface[n] = kind > 0 ? 1.0f : 0.0f;
+        lavaStrip.onCrest[n] = kind == 2 ? 1.0f : 0.0f;
+        lavaStrip.crestSin[n] = kind == 2 ? 5.0f * sin(0.1f * x) : 0.0f;
+        lavaStrip.crestCos[n] = kind == 2 ? 5.0f * cos(0.1f * x) : 0.0f;
+        unsigned char rgba[4] = {r, g, 0, 255};
+        std::copy(rgba, rgba + 4, lavaStrip.color[n]);
+        lavaStrip.position[n][0] = x;
+        lavaStrip.position[n][1] = 0.0f;
+        n++;
+    };
+    
+    const float columnWidth = (float)WIDTH / LAVA_COLUMNS;
+    for (int i = 0; i <= LAVA_COLUMNS; i++) {
+        add(i * columnWidth, 0, 255, 51);
+        add(i * columnWidth, 1, 255, 51);
+    }
+    add(WIDTH, 1, 255, 51); // Degenerate triangles join body and crest
+    add(0, 1, 255, 128);
+    for (int i = 0; i <= LAVA_COLUMNS; i++) {
+        add(i * columnWidth, 1, 255, 128);
+        add(i * columnWidth, 2, 255, 204);
+    }
+}
+
+// Render backends. Draw code issues immediate-mode style gfx* calls: the legacy
+// backend forwards them to fixed-function GL, the core backend (--renderer=core)
+// batches them into VBOs drawn with GLSL 3.30 shaders on a 3.3 core-profile context.
+enum RenderBackend {
+    RENDER_LEGACY,  // Fixed-function GL (default, works everywhere)
+    RENDER_CORE     // GL 3.3 core profile: VAOs, VBOs and shaders
+};
+RenderBackend renderBackend = RENDER_LEGACY;
+
+// Batched vertex: position already transformed to world space
+struct CoreVertex {
+    float x, y;
+    float u, v;
+    GLubyte r, g, b, a;
+};
+
+// Per-instance data for the color shader: offset, scale and tint
+struct CoreInstance {
+    float x, y;
+    float scaleX, scaleY;
+    GLubyte r, g, b, a;
+};
+
+// Run of batched vertices drawn with one texture (0 = untextured)
+struct CoreDrawRange {
+    GLuint texture;
+    GLint first;
+    GLsizei count;
+};
+
+// Geometry captured once into a static VBO and replayed (core stand-in for a display list)
+struct CoreRetainedBatch {
+    GLuint vao = 0, vbo = 0;
+    std::vector<CoreDrawRange> ranges;
+};
+
+struct CoreRenderer {
+    GLuint colorProgram = 0;    // Flat/gouraud color with per-instance transform
+    GLuint textureProgram = 0;  // Textured quads (logo, font)
+    GLuint sunsetProgram = 0;   // Procedural sky gradient
+    GLuint lavaProgram = 0;     // Lava body and waves animated in the vertex shader
+    GLint sunsetCycleLoc = -1;
+    GLint lavaHeightLoc = -1, lavaTimeLoc = -1;
+
+    GLuint streamVao = 0, streamVbo = 0;  // Per-frame batches
+    size_t streamCapacity = 0;
+    GLuint skyVao = 0, skyVbo = 0;
+    GLuint lavaVao = 0, lavaVbo = 0;
+    GLuint hexagonVao = 0, hexagonVbo = 0, instanceVbo = 0;
+    size_t instanceCapacity = 0;
+    GLuint fontTexture = 0;
+
+    // Immediate-mode emulation state
+    std::vector<CoreVertex> batch;
+    std::vector<CoreVertex> primitive;
+    GLenum primitiveMode = GL_TRIANGLES;
+    GLuint batchTexture = 0;
+    GLuint boundTexture = 0;
+    bool texturing = false;
+    GLubyte color[4] = {255, 255, 255, 255};
+    float texU = 0.0f, texV = 0.0f;
+    float matrix[6] = {1, 0, 0, 1, 0, 0};  // x' = m0*x + m2*y + m4, y' = m1*x + m3*y + m5
+    std::vector<std::array<float, 6>> matrixStack;
+
+    // Retained batch being recorded (batches are captured instead of drawn)
+    CoreRetainedBatch* recording = nullptr;
+    std::vector<CoreVertex> recordedVertices;
+} core;
+
+const char* coreColorVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 aPosition;
+layout(location = 2) in vec4 aColor;
+layout(location = 3) in vec4 aInstance;      // xy = offset, zw = scale
+layout(location = 4) in vec4 aInstanceColor;
+uniform mat4 uProjection;
+out vec4 vColor;
+void main() {
+    vColor = aColor * aInstanceColor;
+    gl_Position = uProjection * vec4(aPosition * aInstance.zw + aInstance.xy, 0.0, 1.0);
+}
+)";
+
+const char* coreColorFragmentShader = R"(#version 330 core
+in vec4 vColor;
+out vec4 fragColor;
+void main() {
+    fragColor = vColor;
+}
+)";
+
+const char* coreTextureVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec4 aColor;
+uniform mat4 uProjection;
+out vec2 vTexCoord;
+out vec4 vColor;
+void main() {
+    vTexCoord = aTexCoord;
+    vColor = aColor;
+    gl_Position = uProjection * vec4(aPosition, 0.0, 1.0);
+}
+)";
+
+const char* coreTextureFragmentShader = R"(#version 330 core
+uniform sampler2D uTexture;
+in vec2 vTexCoord;
+in vec4 vColor;
+out vec4 fragColor;
+void main() {
+    fragColor = texture(uTexture, vTexCoord) * vColor;
+}
+)";
+
+const char* coreSunsetVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in float aHeight;  // 0 at the bottom of the screen, 1 at the top
+uniform mat4 uProjection;
+out float vHeight;
+void main() {
+    vHeight = aHeight;
+    gl_Position = uProjection * vec4(aPosition, 0.0, 1.0);
+}
+)";
+
+// Same color stops as the legacy four-band gradient
+const char* coreSunsetFragmentShader = R"(#version 330 core
+uniform float uCycle;
+in float vHeight;
+out vec4 fragColor;
+void main() {
+    vec3 top = vec3(0.3, 0.1, 0.5) * uCycle;
+    vec3 upper = vec3(0.8, 0.3, 0.6) * uCycle;
+    vec3 horizon = vec3(1.0, 0.5, 0.2) * uCycle;
+    vec3 lower = vec3(0.4, 0.2, 0.4) * uCycle;
+    vec3 bottom = vec3(0.1, 0.05, 0.15);
+    vec3 color;
+    if (vHeight > 0.75) color = mix(upper, top, (vHeight - 0.75) * 4.0);
+    else if (vHeight > 0.5) color = mix(horizon, upper, (vHeight - 0.5) * 4.0);
+    else if (vHeight > 0.25) color = mix(lower, horizon, (vHeight - 0.25) * 4.0);
+    else color = mix(bottom, lower, vHeight * 4.0);
+    fragColor = vec4(color, 1.0);
+}
+)";
+
+// Lava vertices are static; height and wave motion come from uniforms
+const char* coreLavaVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 aLava;  // x, kind (0 = floor, 1 = surface, 2 = wave tip)
+layout(location = 2) in vec4 aColor;
+uniform mat4 uProjection;
+uniform float uLavaHeight;
+uniform float uTime;
+out vec4 vColor;
+void main() {
+    float y = 0.0;
+    if (aLava.y > 0.5) y = uLavaHeight;
+    if (aLava.y > 1.5) y += 10.0 + sin((aLava.x + uTime * 100.0) * 0.1) * 5.0 + sin(uTime * 5.0) * 5.0;
+    vColor = aColor;
+    gl_Position = uProjection * vec4(aLava.x, y, 0.0, 1.0);
+}
+)";
+
+// 5x7 glyphs for ASCII 32..126, one byte per column, bit 0 = top row.
+// GLUT bitmap fonts go through glBitmap, which core profiles do not have.
+const GLubyte coreFontGlyphs[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+    {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x41,0x22,0x14,0x08,0x00}, {0x02,0x01,0x51,0x09,0x06},
+    {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x01,0x01}, {0x3E,0x41,0x41,0x51,0x32},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x04,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},
+    {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x7F,0x20,0x18,0x20,0x7F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x00,0x7F,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x41,0x41,0x7F,0x00,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},
+    {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x08,0x14,0x54,0x54,0x3C},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x00,0x7F,0x10,0x28,0x44},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+    {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08},
+};
+const int CORE_GLYPH_CELL = 6;     // Texels per glyph in the font texture (5 + 1 spacing)
+const float CORE_GLYPH_SCALE = 2.0f;
+const int CORE_GLYPH_ADVANCE = 12; // Screen pixels per character
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Shader compile failed: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint linkProgram(const char* vertexSource, const char* fragmentSource) {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) return 0;
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Shader link failed: " << log << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Attribute layout of CoreVertex for the currently bound VAO/VBO
+void coreVertexLayout() {
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(CoreVertex), (void*)offsetof(CoreVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(CoreVertex), (void*)offsetof(CoreVertex, u));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CoreVertex), (void*)offsetof(CoreVertex, r));
+}
+
+void coreSetProjection(float left, float right, float bottom, float top) {
+    const float projection[16] = {
+        2.0f / (right - left), 0, 0, 0,
+        0, 2.0f / (top - bottom), 0, 0,
+        0, 0, -1, 0,
+        -(right + left) / (right - left), -(top + bottom) / (top - bottom), 0, 1
+    };
+    GLuint programs[] = {core.colorProgram, core.textureProgram, core.sunsetProgram, core.lavaProgram};
+    for (GLuint program : programs) {
+        glUseProgram(program);
+        glUniformMatrix4fv(glGetUniformLocation(program, "uProjection"), 1, GL_FALSE, projection);
+    }
+}
+
+// Set up shaders and static geometry; false if the context can't run the core path
+bool initCoreRenderer() {
+    const char* version = (const char*)glGetString(GL_VERSION);
+    int major = 0, minor = 0;
+    if (!version || sscanf(version, "%d.%d", &major, &minor) != 2 || major * 10 + minor < 33) {
+        std::cerr << "Core renderer needs OpenGL 3.3, context is " << (version ? version : "unknown") << std::endl;
+        return false;
+    }
+
+    core.colorProgram = linkProgram(coreColorVertexShader, coreColorFragmentShader);
+    core.textureProgram = linkProgram(coreTextureVertexShader, coreTextureFragmentShader);
+    core.sunsetProgram = linkProgram(coreSunsetVertexShader, coreSunsetFragmentShader);
+    core.lavaProgram = linkProgram(coreLavaVertexShader, coreColorFragmentShader);
+    if (!core.colorProgram || !core.textureProgram || !core.sunsetProgram || !core.lavaProgram) return false;
+
+    glUseProgram(core.textureProgram);
+    glUniform1i(glGetUniformLocation(core.textureProgram, "uTexture"), 0);
+    core.sunsetCycleLoc = glGetUniformLocation(core.sunsetProgram, "uCycle");
+    core.lavaHeightLoc = glGetUniformLocation(core.lavaProgram, "uLavaHeight");
+    core.lavaTimeLoc = glGetUniformLocation(core.lavaProgram, "uTime");
+    coreSetProjection(0, WIDTH, 0, HEIGHT);
+
+    // Stream buffer for immediate-mode batches
+    glGenVertexArrays(1, &core.streamVao);
+    glGenBuffers(1, &core.streamVbo);
+    glBindVertexArray(core.streamVao);
+    glBindBuffer(GL_ARRAY_BUFFER, core.streamVbo);
+    coreVertexLayout();
+
+    // Full-screen quad for the sky: position and normalized height
+    const float sky[] = {0, 0, 0, WIDTH, 0, 0, WIDTH, HEIGHT, 1, 0, HEIGHT, 1};
+    glGenVertexArrays(1, &core.skyVao);
+    glGenBuffers(1, &core.skyVbo);
+    glBindVertexArray(core.skyVao);
+    glBindBuffer(GL_ARRAY_BUFFER, core.skyVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(sky), sky, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    // Lava strip: static x/kind/color, the vertex shader supplies the heights
+    struct LavaVertex { float x, kind; GLubyte r, g, b, a; };
+    std::vector<LavaVertex> lava(LAVA_STRIP_VERTICES);
+    for (int i = 0; i < LAVA_STRIP_VERTICES; i++) {
+        lava[i] = {lavaStrip.x[i], lavaStrip.kind[i], lavaStrip.color[i][0], lavaStrip.color[i][1],
+                   lavaStrip.color[i][2], lavaStrip.color[i][3]};
+    }
+    glGenVertexArrays(1, &core.lavaVao);
+    glGenBuffers(1, &core.lavaVbo);
+    glBindVertexArray(core.lavaVao);
+    glBindBuffer(GL_ARRAY_BUFFER, core.lavaVbo);
+    glBufferData(GL_ARRAY_BUFFER, lava.size() * sizeof(LavaVertex), lava.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(LavaVertex), (void*)offsetof(LavaVertex, x));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LavaVertex), (void*)offsetof(LavaVertex, r));
+
+    // Unit hexagon drawn once per instance (background particles)
+    float hexagon[12];
+    for (int i = 0; i < 6; i++) {
+        float angle = 2.0f * M_PI * i / 6;
+        hexagon[i * 2] = cos(angle);
+        hexagon[i * 2 + 1] = sin(angle);
+    }
+    glGenVertexArrays(1, &core.hexagonVao);
+    glGenBuffers(1, &core.hexagonVbo);
+    glGenBuffers(1, &core.instanceVbo);
+    glBindVertexArray(core.hexagonVao);
+    glBindBuffer(GL_ARRAY_BUFFER, core.hexagonVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(hexagon), hexagon, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, core.instanceVbo);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(CoreInstance), (void*)offsetof(CoreInstance, x));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CoreInstance), (void*)offsetof(CoreInstance, r));
+    glVertexAttribDivisor(4, 1);
+    glBindVertexArray(0);
+
+    // Attributes a VAO doesn't enable fall back to these: white, no instance transform
+    glVertexAttrib4f(2, 1, 1, 1, 1);
+    glVertexAttrib4f(3, 0, 0, 1, 1);
+    glVertexAttrib4f(4, 1, 1, 1, 1);
+
+    // Font texture: glyphs side by side in one 8-texel-high strip
+    const int fontWidth = 95 * CORE_GLYPH_CELL;
+    std::vector<GLubyte> font(fontWidth * 8 * 4, 255);
+    for (int glyph = 0; glyph < 95; glyph++) {
+        for (int column = 0; column < CORE_GLYPH_CELL; column++) {
+            GLubyte bits = column < 5 ? coreFontGlyphs[glyph][column] : 0;
+            for (int row = 0; row < 8; row++) {
+                font[(row * fontWidth + glyph * CORE_GLYPH_CELL + column) * 4 + 3] = (bits >> row) & 1 ? 255 : 0;
+            }
+        }
+    }
+    glGenTextures(1, &core.fontTexture);
+    glBindTexture(GL_TEXTURE_2D, core.fontTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fontWidth, 8, 0, GL_RGBA, GL_UNSIGNED_BYTE, font.data());
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+// Draw batched vertices from the bound VAO with the shader matching their texture
+void coreDrawRange(const CoreDrawRange& range) {
+    if (range.texture) {
+        glUseProgram(core.textureProgram);
+        glBindTexture(GL_TEXTURE_2D, range.texture);
+    } else {
+        glUseProgram(core.colorProgram);
+    }
+    glDrawArrays(GL_TRIANGLES, range.first, range.count);
+}
+
+// Submit the pending batch (or append it to the retained batch being recorded)
+void coreFlush() {
+    if (core.batch.empty()) return;
+
+    if (core.recording) {
+        GLint first = (GLint)core.recordedVertices.size();
+        core.recordedVertices.insert(core.recordedVertices.end(), core.batch.begin(), core.batch.end());
+        core.recording->ranges.push_back({core.batchTexture, first, (GLsizei)core.batch.size()});
+        core.batch.clear();
+        return;
+    }
+
+    size_t bytes = core.batch.size() * sizeof(CoreVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, core.streamVbo);
+    if (bytes > core.streamCapacity) {
+        core.streamCapacity = std::max(bytes, core.streamCapacity * 2);
+    }
+    glBufferData(GL_ARRAY_BUFFER, core.streamCapacity, nullptr, GL_STREAM_DRAW); // Orphan last frame's storage
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, core.batch.data());
+    glBindVertexArray(core.streamVao);
+    coreDrawRange({core.batchTexture, 0, (GLsizei)core.batch.size()});
+    core.batch.clear();
+}
+
+// Lines become 1px-wide quads so they share the triangle batch
+void coreLine(const CoreVertex& a, const CoreVertex& b) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float length = sqrt(dx * dx + dy * dy);
+    if (length < 0.0001f) return;
+    float nx = -dy / length * 0.5f, ny = dx / length * 0.5f;
+
+    CoreVertex a0 = a, a1 = a, b0 = b, b1 = b;
+    a0.x += nx; a0.y += ny; a1.x -= nx; a1.y -= ny;
+    b0.x += nx; b0.y += ny; b1.x -= nx; b1.y -= ny;
+    core.batch.insert(core.batch.end(), {a0, a1, b1, a0, b1, b0});
+}
+
+// Convert the finished primitive to triangles and append it to the batch
+void coreEndPrimitive() {
+    GLuint texture = core.texturing ? core.boundTexture : 0;
+    if (texture != core.batchTexture) {
+        coreFlush();
+        core.batchTexture = texture;
+    }
+
+    const std::vector<CoreVertex>& p = core.primitive;
+    std::vector<CoreVertex>& out = core.batch;
+    size_t n = p.size();
+    switch (core.primitiveMode) {
+        case GL_TRIANGLES:
+            out.insert(out.end(), p.begin(), p.begin() + n / 3 * 3);
+            break;
+        case GL_QUADS:
+            for (size_t i = 0; i + 3 < n; i += 4) {
+                out.insert(out.end(), {p[i], p[i + 1], p[i + 2], p[i], p[i + 2], p[i + 3]});
+            }
+            break;
+        case GL_POLYGON:
+        case GL_TRIANGLE_FAN:
+            for (size_t i = 1; i + 1 < n; i++) {
+                out.insert(out.end(), {p[0], p[i], p[i + 1]});
+            }
+            break;
+        case GL_TRIANGLE_STRIP:
+            for (size_t i = 0; i + 2 < n; i++) {
+                out.insert(out.end(), {p[i], p[i + 1], p[i + 2]});
+            }
+            break;
+        case GL_LINES:
+            for (size_t i = 0; i + 1 < n; i += 2) coreLine(p[i], p[i + 1]);
+            break;
+        case GL_LINE_STRIP:
+        case GL_LINE_LOOP:
+            for (size_t i = 0; i + 1 < n; i++) coreLine(p[i], p[i + 1]);
+            if (core.primitiveMode == GL_LINE_LOOP && n > 2) coreLine(p[n - 1], p[0]);
+            break;
+    }
+}
+
+// Immediate-mode API used by all draw code
+inline void gfxBegin(GLenum mode) {
+    if (renderBackend == RENDER_LEGACY) { glBegin(mode); return; }
+    core.primitiveMode = mode;
+    core.primitive.clear();
+}
+
+inline void gfxEnd() {
+    if (renderBackend == RENDER_LEGACY) { glEnd(); return; }
+    coreEndPrimitive();
+}
+
+inline void gfxVertex2f(float x, float y) {
+    if (renderBackend == RENDER_LEGACY) { glVertex2f(x, y); return; }
+    const float* m = core.matrix;
+    core.primitive.push_back({m[0] * x + m[2] * y + m[4], m[1] * x + m[3] * y + m[5], core.texU, core.texV,
+                              core.color[0], core.color[1], core.color[2], core.color[3]});
+}
+
+inline void gfxColor4f(float r, float g, float b, float a) {
+    if (renderBackend == RENDER_LEGACY) { glColor4f(r, g, b, a); return; }
+    float rgba[4] = {r, g, b, a};
+    for (int i = 0; i < 4; i++) {
+        core.color[i] = (GLubyte)(std::max(0.0f, std::min(1.0f, rgba[i])) * 255.0f + 0.5f);
+    }
+}
+
+inline void gfxColor3f(float r, float g, float b) {
+    if (renderBackend == RENDER_LEGACY) { glColor3f(r, g, b); return; }
+    gfxColor4f(r, g, b, 1.0f);
+}
+
+inline void gfxTexCoord2f(float u, float v) {
+    if (renderBackend == RENDER_LEGACY) { glTexCoord2f(u, v); return; }
+    core.texU = u;
+    core.texV = v;
+}
+
+inline void gfxEnableTexture(GLuint texture) {
+    if (renderBackend == RENDER_LEGACY) {
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        return;
+    }
+    core.texturing = true;
+    core.boundTexture = texture;
+}
+
+inline void gfxDisableTexture() {
+    if (renderBackend == RENDER_LEGACY) { glDisable(GL_TEXTURE_2D); return; }
+    core.texturing = false;
+}
+
+inline void gfxLoadIdentity() {
+    if (renderBackend == RENDER_LEGACY) { glLoadIdentity(); return; }
+    const float identity[6] = {1, 0, 0, 1, 0, 0};
+    std::copy(identity, identity + 6, core.matrix);
+    core.matrixStack.clear();
+}
+
+inline void gfxPushMatrix() {
+    if (renderBackend == RENDER_LEGACY) { glPushMatrix(); return; }
+    std::array<float, 6> saved;
+    std::copy(core.matrix, core.matrix + 6, saved.begin());
+    core.matrixStack.push_back(saved);
+}
+
+inline void gfxPopMatrix() {
+    if (renderBackend == RENDER_LEGACY) { glPopMatrix(); return; }
+    if (core.matrixStack.empty()) return;
+    std::copy(core.matrixStack.back().begin(), core.matrixStack.back().end(), core.matrix);
+    core.matrixStack.pop_back();
+}
+
+inline void gfxTranslatef(float x, float y, float z) {
+    if (renderBackend == RENDER_LEGACY) { glTranslatef(x, y, z); return; }
+    float* m = core.matrix;
+    m[4] += m[0] * x + m[2] * y;
+    m[5] += m[1] * x + m[3] * y;
+}
+
+inline void gfxScalef(float x, float y, float z) {
+    if (renderBackend == RENDER_LEGACY) { glScalef(x, y, z); return; }
+    float* m = core.matrix;
+    m[0] *= x; m[1] *= x;
+    m[2] *= y; m[3] *= y;
+}
+
+// Rotation about the z axis (the only axis this 2D game rotates around)
+inline void gfxRotatef(float degrees, float x, float y, float z) {
+    if (renderBackend == RENDER_LEGACY) { glRotatef(degrees, x, y, z); return; }
+    float radians = degrees * M_PI / 180.0f;
+    float c = cos(radians), s = sin(radians);
+    float* m = core.matrix;
+    float a = m[0], b = m[1], cc = m[2], d = m[3];
+    m[0] = a * c + cc * s;
+    m[1] = b * c + d * s;
+    m[2] = -a * s + cc * c;
+    m[3] = -b * s + d * c;
+}
+
+// Submit everything batched so far (end of frame, or before a non-batched draw)
+inline void gfxFlush() {
+    if (renderBackend == RENDER_CORE) coreFlush();
+}
+
+// Textured drawing from a premultiplied-alpha texture (the sprite atlas)
+inline void gfxBeginPremultiplied(GLuint texture) {
+    gfxFlush();
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    gfxEnableTexture(texture);
+    gfxColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+inline void gfxEndPremultiplied() {
+    gfxFlush();
+    gfxDisableTexture();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// Text with the built-in font; the current color applies
+void coreDrawText(float x, float y, const char* text) {
+    bool wasTexturing = core.texturing;
+    GLuint previousTexture = core.boundTexture;
+    gfxEnableTexture(core.fontTexture);
+
+    const float texelWidth = 1.0f / (95 * CORE_GLYPH_CELL);
+    const float glyphWidth = 5 * CORE_GLYPH_SCALE, glyphHeight = 8 * CORE_GLYPH_SCALE;
+    gfxBegin(GL_QUADS);
+    for (; *text; text++, x += CORE_GLYPH_ADVANCE) {
+        int glyph = (*text >= 32 && *text <= 126) ? *text - 32 : 0;
+        if (glyph == 0) continue;
+        float u0 = glyph * CORE_GLYPH_CELL * texelWidth, u1 = u0 + 5 * texelWidth;
+        float bottom = y - CORE_GLYPH_SCALE; // Row 7 sits below the baseline
+        gfxTexCoord2f(u0, 1); gfxVertex2f(x, bottom);
+        gfxTexCoord2f(u1, 1); gfxVertex2f(x + glyphWidth, bottom);
+        gfxTexCoord2f(u1, 0); gfxVertex2f(x + glyphWidth, bottom + glyphHeight);
+        gfxTexCoord2f(u0, 0); gfxVertex2f(x, bottom + glyphHeight);
+    }
+    gfxEnd();
+
+    core.texturing = wasTexturing;
+    core.boundTexture = previousTexture;
+}
+
+// Sky gradient computed per fragment instead of four gouraud bands
+void coreDrawSunset(float sunsetCycle) {
+    coreFlush();
+    glUseProgram(core.sunsetProgram);
+    glUniform1f(core.sunsetCycleLoc, sunsetCycle);
+    glBindVertexArray(core.skyVao);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
+// Lava geometry is static; the vertex shader raises it and animates the waves
+void coreDrawLava(float height, float time) {
+    coreFlush();
+    glUseProgram(core.lavaProgram);
+    glUniform1f(core.lavaHeightLoc, height);
+    glUniform1f(core.lavaTimeLoc, time);
+    glBindVertexArray(core.lavaVao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, LAVA_STRIP_VERTICES);
+}
+
+// One instanced draw of unit hexagons, each placed and tinted by its instance
+void coreDrawHexagons(const std::vector<CoreInstance>& instances) {
+    if (instances.empty()) return;
+    coreFlush();
+
+    size_t bytes = instances.size() * sizeof(CoreInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, core.instanceVbo);
+    if (bytes > core.instanceCapacity) {
+        core.instanceCapacity = std::max(bytes, core.instanceCapacity * 2);
+    }
+    glBufferData(GL_ARRAY_BUFFER, core.instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data());
+
+    glUseProgram(core.colorProgram);
+    glBindVertexArray(core.hexagonVao);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 6, (GLsizei)instances.size());
+}
+
+// Start capturing batches into a retained VBO instead of drawing them
+void coreBeginRetained(CoreRetainedBatch& retained) {
+    coreFlush();
+    core.recording = &retained;
+    core.recordedVertices.clear();
+    retained.ranges.clear();
+}
+
+void coreEndRetained() {
+    coreFlush();
+    CoreRetainedBatch& retained = *core.recording;
+    core.recording = nullptr;
+
+    if (retained.vao == 0) {
+        glGenVertexArrays(1, &retained.vao);
+        glGenBuffers(1, &retained.vbo);
+        glBindVertexArray(retained.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, retained.vbo);
+        coreVertexLayout();
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, retained.vbo);
+    glBufferData(GL_ARRAY_BUFFER, core.recordedVertices.size() * sizeof(CoreVertex),
+                 core.recordedVertices.data(), GL_STATIC_DRAW);
+}
+
+void coreDrawRetained(const CoreRetainedBatch& retained) {
+    coreFlush();
+    glBindVertexArray(retained.vao);
+    for (const CoreDrawRange& range : retained.ranges) coreDrawRange(range);
+}
+
 // Game states
 enum GameState {
     START_MENU,
@@ -51,7 +790,7 @@ enum CharacterSelection {
 };
 
 // Game variables
-GameState gameState = START_MENU;
+std::atomic<GameState> gameState{START_MENU}; // Read by the simulation thread
 int score = 0;
 int playerLives = 3;
 float gameTime = 0.0f;
@@ -87,6 +826,20 @@ struct Player {
     bool hasDoubleJumped;
 } player;
 
+// Player movement tuning (shared by update() and the level validator)
+const float PLAYER_WIDTH = 30.0f;
+const float PLAYER_HEIGHT = 40.0f;
+const float PLAYER_GRAVITY = 750.0f;
+const float PLAYER_JUMP_VELOCITY = 400.0f;
+const float PLAYER_DOUBLE_JUMP_VELOCITY = 310.0f;
+const float PLAYER_ACCELERATION = 1200.0f;
+const float PLAYER_MAX_SPEED = 280.0f;
+// Fraction of horizontal speed kept per 1/60 s with no key held; applied as
+// exponential decay over deltaTime so coasting is the same at any frame rate
+const float PLAYER_GROUND_DAMPING = 0.80f;
+const float PLAYER_AIR_DAMPING = 0.92f;
+const float DAMPING_REFERENCE_RATE = 60.0f;
+
 // Movement input state for smooth acceleration
 bool leftPressed = false;
 bool rightPressed = false;
@@ -128,6 +881,139 @@ std::vector<PowerUp> powerUps;
 float lavaHeight = 50.0f;
 float lavaSpeed = 0.5f;
 
+// Stress-test mode: multiplies entity counts to measure how costs scale with N
+struct StressConfig {
+    bool enabled = false;
+    float rockRate = 1.0f;   // Multiplier on rock spawn frequency
+    float platforms = 1.0f;  // Multiplier on platform count
+    float coins = 1.0f;      // Multiplier on coin count
+    float particles = 1.0f;  // Multiplier on background particle count
+} stress;
+
+// Ground + climbing path + door platform; stress-mode extras are appended after these
+int mainPathPlatformCount = 0;
+
+// Distribution of a latency over one telemetry window, in 0.5 ms buckets
+struct LatencyHistogram {
+    static const int BUCKETS = 400; // Up to 200 ms; the last bucket also takes anything slower
+    int counts[BUCKETS] = {};
+    int total = 0;
+    double maxMs = 0.0;
+    
+    void record(double ms) {
+        counts[std::min(std::max((int)(ms * 2.0), 0), BUCKETS - 1)]++;
+        total++;
+        maxMs = std::max(maxMs, ms);
+    }
+    
+    // Upper edge of the bucket holding the given fraction of samples
+    double percentile(double fraction) const {
+        int target = (int)ceil(fraction * total), seen = 0;
+        for (int i = 0; i < BUCKETS - 1; i++) {
+            seen += counts[i];
+            if (seen >= target && seen > 0) return std::min((i + 1) * 0.5, maxMs);
+        }
+        return maxMs;
+    }
+    
+    void clear() { *this = LatencyHistogram(); }
+};
+
+// Worker threads shared by asset loading, level generation, batch simulation and
+// particle updates. Started in main(); never destroyed, since its workers are detached
+TaskScheduler& tasks = *new TaskScheduler();
+
+// Frame profiler: CPU cost of update and render, shown as an overlay (F3)
+struct FrameProfiler {
+    bool overlayVisible = false;
+    double updateMs = 0.0;   // Smoothed cost of update()
+    double cosmeticsMs = 0.0; // Smoothed cost of updateCosmetics() (particles, menu animation)
+    double renderMs = 0.0;   // Smoothed cost of issuing draw calls
+    double swapMs = 0.0;     // Smoothed cost of glutSwapBuffers
+    double frameMs = 16.0;   // Smoothed time between displayed frames
+    double lastFrameStart = 0.0;
+    
+    // Telemetry window (printed to stderr in stress mode)
+    double reportStart = 0.0;
+    double reportUpdateSum = 0.0, reportRenderSum = 0.0, reportSwapSum = 0.0;
+    double reportUpdateMax = 0.0, reportRenderMax = 0.0;
+    int reportTicks = 0, reportFrames = 0;
+    
+    // Input latency: key arrival to the end of the tick that applied it, and to the
+    // buffer swap of the first frame drawn from that tick
+    bool latencyReport = false;     // --report-latency: print it even outside stress mode
+    LatencyHistogram inputToSim, inputToSwap;
+    uint32_t lastInputId = 0;       // Newest input already measured
+    double inputAwaitingSwap = 0.0; // Arrival time of the input in the frame being drawn (0 = none)
+    
+    // Task scheduler activity over the last second
+    TaskStats taskTotals;
+    double taskSampleStart = 0.0;
+    double tasksPerSecond = 0.0, stealsPerSecond = 0.0, workerIdlePercent = 0.0;
+} profiler;
+
+// Adaptive quality: decoration detail is stepped down when frames run over budget
+// and restored when there is headroom. Gameplay objects are never dropped.
+struct QualitySettings {
+    bool distantWindowLights;  // Window lights on the slowest skyline layer
+    bool nearWindowLights;     // Window lights on the middle and front skyline layers
+    bool platformDecorations;  // Decorative triangles on top of platforms
+    bool particleGlow;         // Second, larger polygon around each background particle
+    int particleStride;        // Draw every Nth background particle
+    int coinSegments;          // Tessellation of coin circles
+    int vortexLayers;          // Swirl layers inside the unlocked door
+};
+
+const QualitySettings qualityLevels[] = {
+    {true,  true,  true,  true,  1, 24, 3}, // 0: full detail
+    {false, true,  true,  true,  2, 12, 3}, // 1
+    {false, false, false, true,  2, 12, 2}, // 2
+    {false, false, false, false, 4, 12, 1}, // 3: minimum detail
+};
+const int QUALITY_LEVEL_COUNT = sizeof(qualityLevels) / sizeof(qualityLevels[0]);
+
+struct QualityGovernor {
+    int level = 0;
+    bool pinned = false;       // Fixed with --quality=N
+    double budgetMs = 12.0;    // CPU time allowed for update + render per frame
+    int overBudgetFrames = 0;
+    int underBudgetFrames = 0;
+} quality;
+
+const QualitySettings& qualitySettings() {
+    return qualityLevels[quality.level];
+}
+
+// Feed one frame's CPU cost; steps down quickly when over budget, back up slowly
+void updateQualityGovernor(double frameCostMs) {
+    if (quality.pinned) return;
+    
+    if (frameCostMs > quality.budgetMs) {
+        quality.overBudgetFrames++;
+        quality.underBudgetFrames = 0;
+    } else if (frameCostMs < quality.budgetMs * 0.5) {
+        quality.underBudgetFrames++;
+        quality.overBudgetFrames = 0;
+    } else {
+        quality.overBudgetFrames = 0;
+        quality.underBudgetFrames = 0;
+    }
+    
+    if (quality.overBudgetFrames >= 30 && quality.level < QUALITY_LEVEL_COUNT - 1) {
+        quality.level++;
+        quality.overBudgetFrames = 0;
+    } else if (quality.underBudgetFrames >= 180 && quality.level > 0) {
+        quality.level--;
+        quality.underBudgetFrames = 0;
+    }
+}
+
+// Monotonic wall clock in milliseconds
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
 // Falling character structure for win screen
 struct FallingCharacter {
     float x, y;
@@ -159,88 +1045,670 @@ float playerFlipAngle = 0.0f;
 
 // Door suction animation state
 bool playerBeingSucked = false;
-float suctionAnimTime = 0.0f;
-float suctionStartX, suctionStartY;
 float doorCenterX, doorCenterY;
 
-// Terrain generation patterns
-enum TerrainPattern {
-    MIDDLE_FOCUSED,
-    LEFT_FOCUSED, 
-    RIGHT_FOCUSED
+// Door unlock and suction sequences, resumed from update()
+SequenceRunner sequences;
+
+// Earliest key event applied by the simulation that the renderer hasn't picked up
+// yet. Snapshots carry it until one of them has been read, so a snapshot the
+// renderer skips doesn't lose the measurement
+struct AppliedInput {
+    uint32_t id = 0;        // 0 = none
+    double arrivalMs = 0.0; // nowMs() when the key event arrived
+    double appliedMs = 0.0; // End of the tick that applied it
+    bool published = false; // Carried by a snapshot already published
+} pendingInput;             // Simulation side
+
+// Everything the renderer reads from the game, copied out after each simulation
+// tick. Drawing and the cosmetic emitters read the latest snapshot, never the
+// live state the simulation thread is changing
+struct RenderSnapshot {
+    Player player;
+    float playerFlipAngle = 0.0f;
+    std::vector<Platform> platforms;
+    std::vector<Rock> rocks;
+    std::vector<Collectable> collectables;
+    std::vector<PowerUp> powerUps;
+    float lavaHeight = 50.0f;
+    float gameTime = 0.0f;
+    int score = 0;
+    int playerLives = 3;
+    bool keySpawned = false;
+    bool keyCollected = false;
+    float keyX = 0.0f, keyY = 0.0f;
+    float keyAnimTime = 0.0f;
+    float doorAnimTime = 0.0f;
+    float doorUnlockAnimTime = 0.0f;
+    float doorEnterAnimTime = 0.0f;
+    bool doorIsUnlocking = false;
+    bool doorIsEntering = false;
+    bool playerBeingSucked = false;
+    float doorCenterX = 0.0f, doorCenterY = 0.0f;
+    double updateMs = 0.0; // Cost of the tick that produced it
+    AppliedInput input;    // For latency measurement
 };
 
-// Initialize game
-void initGame() {
-    // Don't reseed srand - keep randomization between games
-    static bool seeded = false;
-    if (!seeded) {
-        srand(time(NULL));
-        seeded = true;
+// Lock-free triple buffer from the simulation to the GLUT thread. Each side owns
+// one slot; the third holds the newest finished snapshot and changes hands
+// through a single atomic exchange, so neither side ever waits for the other
+struct RenderSnapshotBuffer {
+    static const int FRESH = 4; // Set while the shared slot holds an unread snapshot
+    RenderSnapshot slots[3];
+    std::atomic<int> shared{1};
+    int writing = 0; // Producer's slot
+    int reading = 2; // Consumer's slot
+    
+    RenderSnapshot& back() { return slots[writing]; }
+    // Returns false if the snapshot it replaces was never read
+    bool publish() {
+        int previous = shared.exchange(writing | FRESH, std::memory_order_acq_rel);
+        writing = previous & 3;
+        return !(previous & FRESH);
     }
     
-    // Reset movement keys
-    leftPressed = false;
-    rightPressed = false;
-    
-    // Initialize player with better stats
-    player.x = WIDTH / 2.0f;
-    player.y = 110.0f; // Start slightly higher
-    player.velocityX = 0.0f;
-    player.velocityY = 0.0f;
-    player.width = 30.0f;
-    player.height = 40.0f;
-    player.onGround = false;
-    player.hasKey = false;
-    player.powerUpType = 0;
-    player.powerUpTimer = 0.0f;
-    player.canDoubleJump = false;
-    player.hasDoubleJumped = false;
-    
-    // Create platforms with different sizes
-    platforms.clear();
-    
-    // Ground platform
-    platforms.push_back({0, 80, WIDTH, 20, true});
-    
-    // Choose random terrain pattern
-    TerrainPattern pattern = (TerrainPattern)(rand() % 3);
-    
-    // Level platforms with challenging, varied generation
-    float platformY = 135; // Start slightly higher
-    const int baseWidths[4] = {50, 100, 150, 200};
-    for (int i = 0; i < 25; i++) { // More platforms for increased height
-        // Pick one of the 4 main lengths with variation
-        int w = baseWidths[rand() % 4];
-        int jitter = (rand() % 21) - 10; // -10..+10 for more variation
-        float platformWidth = std::max(40, w + jitter);
-        
-        // Generate platform position using edge-to-edge offset rule (±50)
-        float platformX;
-        if (i == 0) {
-            platformX = WIDTH / 2 - platformWidth / 2; // Center first platform
-        } else {
-            const Platform& prev = platforms.back();
-            float prevLeft = prev.x;
-            float prevRight = prev.x + prev.width;
-            bool attachRight = rand() % 2; // Randomly branch left/right
-            float minLeft, maxLeft;
-            if (attachRight) {
-                // New left edge within ±50 of previous right edge
-                minLeft = prevRight - 50.0f;
-                maxLeft = prevRight + 50.0f - platformWidth;
-            } else {
-                // New right edge within ±50 of previous left edge
-                minLeft = (prevLeft - 50.0f) - platformWidth;
-                maxLeft = (prevLeft + 50.0f) - platformWidth;
-            }
-            // Clamp to screen bounds
-            minLeft = std::max(0.0f, minLeft);
-            maxLeft = std::min((float)(WIDTH - platformWidth), maxLeft);
-            
-            if (minLeft <= maxLeft) {
+    // Switch to the newest published snapshot; false if there was none
+    bool acquire() {
+        if (!(shared.load(std::memory_order_relaxed) & FRESH)) return false;
+        reading = shared.exchange(reading, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+    const RenderSnapshot& front() const { return slots[reading]; }
+} renderSnapshots;
+
+// Called with the world locked (or from the only thread touching it)
+void publishRenderSnapshot(double updateMs) {
+    RenderSnapshot& s = renderSnapshots.back();
+    s.player = player;
+    s.playerFlipAngle = playerFlipAngle;
+    s.platforms = platforms; // Assignment reuses the slot's capacity
+    s.rocks = rocks;
+    s.collectables = collectables;
+    s.powerUps = powerUps;
+    s.lavaHeight = lavaHeight;
+    s.gameTime = gameTime;
+    s.score = score;
+    s.playerLives = playerLives;
+    s.keySpawned = keySpawned;
+    s.keyCollected = keyCollected;
+    s.keyX = keyX;
+    s.keyY = keyY;
+    s.keyAnimTime = keyAnimTime;
+    s.doorAnimTime = doorAnimTime;
+    s.doorUnlockAnimTime = doorUnlockAnimTime;
+    s.doorEnterAnimTime = doorEnterAnimTime;
+    s.doorIsUnlocking = doorIsUnlocking;
+    s.doorIsEntering = doorIsEntering;
+    s.playerBeingSucked = playerBeingSucked;
+    s.doorCenterX = doorCenterX;
+    s.doorCenterY = doorCenterY;
+    s.updateMs = updateMs;
+    s.input = pendingInput;
+    bool previousRead = renderSnapshots.publish();
+    if (pendingInput.published && previousRead) {
+        pendingInput = AppliedInput(); // The renderer has it
+    } else if (pendingInput.id != 0) {
+        pendingInput.published = true;
+    }
+}
+
+// Effects and sounds raised by update(), handed to the GLUT thread, which owns
+// the particle systems and launches the sound player
+enum GameEffect { EFFECT_ROCK_DEBRIS, EFFECT_COIN_SPARKLES, EFFECT_SOUND, EFFECT_WIN_SCREEN };
+
+struct GameEffectEvent {
+    GameEffect type;
+    float x, y;
+    const char* sound;
+};
+
+// Lock-free single-producer single-consumer ring; push() fails when it is full
+template <typename T, unsigned CAPACITY>
+struct SpscRing {
+    T events[CAPACITY];
+    std::atomic<unsigned> head{0}; // Next slot to write (producer)
+    std::atomic<unsigned> tail{0}; // Next slot to read (consumer)
+    
+    bool push(const T& event) {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == CAPACITY) return false;
+        events[h % CAPACITY] = event;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& event) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        event = events[t % CAPACITY];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+SpscRing<GameEffectEvent, 256> gameEffects; // Dropped when full: they are only cosmetic
+
+void queueEffect(GameEffect type, float x, float y) { gameEffects.push({type, x, y, nullptr}); }
+void queueSound(const char* filename) { gameEffects.push({EFFECT_SOUND, 0.0f, 0.0f, filename}); }
+
+// Gameplay input, timestamped by the GLUT callbacks and applied by the simulation
+enum InputAction { INPUT_LEFT_DOWN, INPUT_LEFT_UP, INPUT_RIGHT_DOWN, INPUT_RIGHT_UP, INPUT_JUMP, INPUT_QUIT };
+
+struct InputEvent {
+    uint32_t id;   // Sequence number, from 1
+    double timeMs; // nowMs() when the key event arrived
+    InputAction action;
+    uint32_t game; // inputGame when it was queued
+};
+
+SpscRing<InputEvent, 256> inputEvents;
+// Bumped by initGame(). The simulation drops events queued for an earlier game,
+// so the GLUT thread never has to pop the ring it produces into
+std::atomic<uint32_t> inputGame{0};
+
+// Simulation thread state. While a game is in progress update() runs on its own
+// thread at a fixed tick; input handlers lock worldMutex while they touch game state
+struct SimulationThread {
+    bool enabled = true;              // --no-sim-thread runs update() from timer() instead
+    std::mutex worldMutex;            // Held by each tick and by input handlers
+    std::condition_variable wake;     // Signalled on input and window events
+    std::atomic<bool> ticking{false}; // Inside a tick; exit() waits for it to finish
+    std::atomic<bool> exiting{false};
+};
+SimulationThread& simulation = *new SimulationThread(); // Never destroyed: the thread outlives main()
+
+// Particle system. Storage is structure-of-arrays so the per-frame update is a
+// flat pass over float arrays that the compiler vectorises. Emitters append
+// particles; expired ones are removed by moving the last particle into their slot.
+struct ParticleSystem {
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> ax, ay;     // Constant acceleration (gravity, buoyancy)
+    std::vector<float> pull;       // Spring strength toward (attractX, attractY)
+    std::vector<float> life;       // Seconds left; INFINITY never expires
+    std::vector<float> size;
+    std::vector<float> flicker;    // 0 = steady, 1 = pulses like the city lights
+    std::vector<unsigned char> r, g, b, a;
+    float attractX = 0.0f, attractY = 0.0f;
+    bool wrap = false;             // Recycle particles leaving the top of the screen
+
+    size_t count() const { return x.size(); }
+};
+
+ParticleSystem ambientParticles;  // Background dust and city-light specks
+ParticleSystem effectParticles;   // Embers, sparkles, debris and the door spiral
+
+struct ParticleSpawn {
+    float x, y, vx, vy;
+    float ax = 0.0f, ay = 0.0f;
+    float pull = 0.0f;
+    float life = INFINITY;
+    float size = 2.0f;
+    float flicker = 0.0f;
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+};
+
+// Emission rate accumulators (particles owed from fractional per-frame rates)
+float emberEmitDebt = 0.0f;
+float suctionEmitDebt = 0.0f;
+
+// Cosmetic random numbers, kept apart from rand() so effects don't change level generation
+unsigned int particleRandomState = 0x9E3779B9u;
+float particleRandom(float low, float high) {
+    particleRandomState ^= particleRandomState << 13;
+    particleRandomState ^= particleRandomState >> 17;
+    particleRandomState ^= particleRandomState << 5;
+    return low + (high - low) * (particleRandomState & 0xFFFFFF) / (float)0x1000000;
+}
+
+void spawnParticle(ParticleSystem& ps, const ParticleSpawn& p) {
+    ps.x.push_back(p.x);
+    ps.y.push_back(p.y);
+    ps.vx.push_back(p.vx);
+    ps.vy.push_back(p.vy);
+    ps.ax.push_back(p.ax);
+    ps.ay.push_back(p.ay);
+    ps.pull.push_back(p.pull);
+    ps.life.push_back(p.life);
+    ps.size.push_back(p.size);
+    ps.flicker.push_back(p.flicker);
+    ps.r.push_back((unsigned char)(std::min(1.0f, p.r) * 255));
+    ps.g.push_back((unsigned char)(std::min(1.0f, p.g) * 255));
+    ps.b.push_back((unsigned char)(std::min(1.0f, p.b) * 255));
+    ps.a.push_back((unsigned char)(std::min(1.0f, p.a) * 255));
+}
+
+void removeParticle(ParticleSystem& ps, size_t i) {
+    size_t last = ps.count() - 1;
+    for (std::vector<float>* field : {&ps.x, &ps.y, &ps.vx, &ps.vy, &ps.ax, &ps.ay, &ps.pull, &ps.life, &ps.size, &ps.flicker}) {
+        (*field)[i] = (*field)[last];
+        field->pop_back();
+    }
+    for (std::vector<unsigned char>* field : {&ps.r, &ps.g, &ps.b, &ps.a}) {
+        (*field)[i] = (*field)[last];
+        field->pop_back();
+    }
+}
+
+void clearParticles(ParticleSystem& ps) {
+    for (std::vector<float>* field : {&ps.x, &ps.y, &ps.vx, &ps.vy, &ps.ax, &ps.ay, &ps.pull, &ps.life, &ps.size, &ps.flicker}) {
+        field->clear();
+    }
+    for (std::vector<unsigned char>* field : {&ps.r, &ps.g, &ps.b, &ps.a}) {
+        field->clear();
+    }
+}
+
+const int PARTICLE_TASK_GRAIN = 8192; // Particles per task
+
+// Integrate every particle in one branch-free pass, then recycle or remove
+void updateParticles(ParticleSystem& ps, float deltaTime) {
+    size_t n = ps.count();
+    float* __restrict x = ps.x.data();
+    float* __restrict y = ps.y.data();
+    float* __restrict vx = ps.vx.data();
+    float* __restrict vy = ps.vy.data();
+    float* __restrict life = ps.life.data();
+    const float* __restrict ax = ps.ax.data();
+    const float* __restrict ay = ps.ay.data();
+    const float* __restrict pull = ps.pull.data();
+    const float attractX = ps.attractX, attractY = ps.attractY;
+
+    auto integrate = [=](int first, int last) {
+        for (int i = first; i < last; i++) {
+            vx[i] += (ax[i] + pull[i] * (attractX - x[i])) * deltaTime;
+            vy[i] += (ay[i] + pull[i] * (attractY - y[i])) * deltaTime;
+            x[i] += vx[i] * deltaTime;
+            y[i] += vy[i] * deltaTime;
+            life[i] -= deltaTime;
+        }
+    };
+    // Only stress-mode counts are worth the hand-off to the workers
+    if (n >= 2 * PARTICLE_TASK_GRAIN) tasks.parallelFor(0, (int)n, PARTICLE_TASK_GRAIN, integrate);
+    else integrate(0, (int)n);
+
+    if (ps.wrap) {
+        for (size_t i = 0; i < n; i++) {
+            if (y[i] > HEIGHT + 20) {
+                y[i] = -20;
+                x[i] = particleRandom(0, WIDTH);
+            }
+        }
+    }
+    for (size_t i = 0; i < ps.count(); ) {
+        if (ps.life[i] <= 0.0f) removeParticle(ps, i);
+        else i++;
+    }
+}
+
+// Fill the background with slowly rising dust and city-light specks
+void initAmbientParticles() {
+    clearParticles(ambientParticles);
+    ambientParticles.wrap = true;
+    int particleCount = (int)(50 * stress.particles);
+    for (int i = 0; i < particleCount; i++) {
+        ParticleSpawn p;
+        p.x = particleRandom(0, WIDTH);
+        p.y = particleRandom(0, HEIGHT);
+        p.vx = 0.0f;
+        p.vy = particleRandom(5, 20) * 0.5f; // Slow floating for atmospheric effect
+        p.size = 2 + (int)particleRandom(0, 4);
+        p.flicker = 1.0f;
+        float alpha = particleRandom(0.3f, 0.8f);
+        if ((int)p.x % 3 == 0) {
+            // City light reflections - pink/magenta tint
+            p.r = 1.0f; p.g = 0.4f; p.b = 0.8f; p.a = alpha * 0.6f;
+        } else {
+            // Warm atmospheric particles - orange/yellow
+            p.r = 1.0f; p.g = 0.8f; p.b = 0.3f; p.a = alpha * 0.4f;
+        }
+        spawnParticle(ambientParticles, p);
+    }
+}
+
+// Embers rising off the lava surface
+void emitLavaEmbers(float deltaTime) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    emberEmitDebt += 25.0f * stress.particles * deltaTime;
+    for (; emberEmitDebt >= 1.0f; emberEmitDebt -= 1.0f) {
+        ParticleSpawn p;
+        p.x = particleRandom(0, WIDTH);
+        p.y = frame.lavaHeight + particleRandom(0, 15);
+        p.vx = particleRandom(-20, 20);
+        p.vy = particleRandom(60, 130);
+        p.ay = -60.0f;
+        p.life = particleRandom(0.8f, 1.8f);
+        p.size = particleRandom(1.5f, 3.0f);
+        p.flicker = 1.0f;
+        p.r = 1.0f; p.g = particleRandom(0.3f, 0.8f); p.b = 0.0f; p.a = 0.9f;
+        spawnParticle(effectParticles, p);
+    }
+}
+
+// Burst of gold sparkles where a coin was collected
+void emitCoinSparkles(float x, float y) {
+    for (int i = 0; i < 16; i++) {
+        float angle = particleRandom(0, 2.0f * M_PI);
+        float speed = particleRandom(60, 150);
+        ParticleSpawn p;
+        p.x = x;
+        p.y = y;
+        p.vx = cos(angle) * speed;
+        p.vy = sin(angle) * speed;
+        p.ay = -150.0f;
+        p.life = particleRandom(0.4f, 0.8f);
+        p.size = particleRandom(1.5f, 2.5f);
+        p.r = 1.0f; p.g = 0.85f; p.b = 0.2f; p.a = 1.0f;
+        spawnParticle(effectParticles, p);
+    }
+}
+
+// Rock fragments where a rock shattered or fell past the lava surface
+void emitRockDebris(float x, float y) {
+    for (int i = 0; i < 12; i++) {
+        ParticleSpawn p;
+        p.x = x + particleRandom(-8, 8);
+        p.y = y + particleRandom(-8, 8);
+        p.vx = particleRandom(-120, 120);
+        p.vy = particleRandom(40, 180);
+        p.ay = -600.0f;
+        p.life = particleRandom(0.5f, 0.9f);
+        p.size = particleRandom(2.0f, 4.0f);
+        float shade = particleRandom(0.35f, 0.55f);
+        p.r = shade; p.g = shade * 0.7f; p.b = shade * 0.5f; p.a = 1.0f;
+        spawnParticle(effectParticles, p);
+    }
+}
+
+// Green motes spiralling into the door while the player is pulled in
+void emitSuctionSpiral(float deltaTime) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    effectParticles.attractX = frame.doorCenterX;
+    effectParticles.attractY = frame.doorCenterY;
+    suctionEmitDebt += 60.0f * deltaTime;
+    for (; suctionEmitDebt >= 1.0f; suctionEmitDebt -= 1.0f) {
+        float angle = particleRandom(0, 2.0f * M_PI);
+        float radius = particleRandom(90, 140);
+        ParticleSpawn p;
+        p.x = frame.doorCenterX + radius * cos(angle);
+        p.y = frame.doorCenterY + radius * sin(angle);
+        p.vx = -sin(angle) * 160.0f; // Tangential start, the pull turns it into a spiral
+        p.vy = cos(angle) * 160.0f;
+        p.pull = 14.0f;
+        p.life = 0.8f;
+        p.size = particleRandom(1.5f, 3.0f);
+        p.r = 0.4f; p.g = 1.0f; p.b = 0.5f; p.a = 0.8f;
+        spawnParticle(effectParticles, p);
+    }
+}
+
+// Draw particles as hexagons: one instanced draw on the core renderer, one
+// client-array draw on the legacy renderer. Every stride-th particle is drawn.
+void drawParticles(const ParticleSystem& ps, float time, int stride, bool glow) {
+    size_t n = ps.count();
+    static std::vector<CoreInstance> instances;
+    instances.clear();
+    for (size_t i = 0; i < n; i += stride) {
+        float pulse = 1.0f + ps.flicker[i] * (sin(time * 1.5f + ps.x[i] * 0.01f) * 0.4f - 0.4f);
+        float fade = std::min(1.0f, ps.life[i] * 2.0f); // Fade out over the last half second
+        instances.push_back({ps.x[i], ps.y[i], ps.size[i], ps.size[i],
+                             (GLubyte)(ps.r[i] * pulse), (GLubyte)(ps.g[i] * pulse), (GLubyte)(ps.b[i] * pulse),
+                             (GLubyte)(ps.a[i] * fade)});
+        if (glow) {
+            // Subtle glow: a slightly larger, faint warm hexagon over the particle
+            instances.push_back({ps.x[i], ps.y[i], ps.size[i] + 1, ps.size[i] + 1,
+                                 255, 153, 102, (GLubyte)(ps.a[i] * fade * pulse * 0.4f)});
+        }
+    }
+
+    if (instances.empty()) return;
+    if (renderBackend == RENDER_CORE) {
+        coreDrawHexagons(instances);
+        return;
+    }
+
+    // Legacy: expand each instance to a 4-triangle hexagon in client arrays
+    static float unitHexagon[6][2];
+    if (unitHexagon[1][0] == 0.0f) {
+        for (int i = 0; i < 6; i++) {
+            float angle = 2.0f * M_PI * i / 6;
+            unitHexagon[i][0] = cos(angle);
+            unitHexagon[i][1] = sin(angle);
+        }
+    }
+    static const int fan[12] = {0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5};
+    static std::vector<float> positions;
+    static std::vector<GLubyte> colors;
+    positions.resize(instances.size() * 12 * 2);
+    colors.resize(instances.size() * 12 * 4);
+    for (size_t i = 0; i < instances.size(); i++) {
+        const CoreInstance& instance = instances[i];
+        for (int v = 0; v < 12; v++) {
+            size_t out = i * 12 + v;
+            positions[out * 2] = instance.x + instance.scaleX * unitHexagon[fan[v]][0];
+            positions[out * 2 + 1] = instance.y + instance.scaleY * unitHexagon[fan[v]][1];
+            colors[out * 4] = instance.r;
+            colors[out * 4 + 1] = instance.g;
+            colors[out * 4 + 2] = instance.b;
+            colors[out * 4 + 3] = instance.a;
+        }
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, positions.data());
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors.data());
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(instances.size() * 12));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// Terrain generation patterns
+enum TerrainPattern {
+    MIDDLE_FOCUSED,
+    LEFT_FOCUSED, 
+    RIGHT_FOCUSED,
+    TERRAIN_PATTERN_COUNT
+};
+
+// Terrain pattern policies: compile-time parameters that bias where the climb
+// wanders, where coins sit and where pickups spawn. Each one instantiates its own
+// copy of the generator, so the bias costs no per-platform dispatch.
+struct MiddleFocusedTerrain {
+    static constexpr float focusX = WIDTH * 0.5f;  // Column the climb is drawn toward
+    static constexpr int towardFocusPercent = 65;  // Chance a platform branches toward it
+    static constexpr float coinShift = 0.0f;       // Coin offset from its platform's centre
+    static constexpr float pickupLeft = WIDTH * 0.25f, pickupRight = WIDTH * 0.75f; // Spare coin / power-up band
+};
+
+struct LeftFocusedTerrain {
+    static constexpr float focusX = WIDTH * 0.25f;
+    static constexpr int towardFocusPercent = 70;
+    static constexpr float coinShift = -15.0f;
+    static constexpr float pickupLeft = 50.0f, pickupRight = WIDTH * 0.6f;
+};
+
+struct RightFocusedTerrain {
+    static constexpr float focusX = WIDTH * 0.75f;
+    static constexpr int towardFocusPercent = 70;
+    static constexpr float coinShift = 15.0f;
+    static constexpr float pickupLeft = WIDTH * 0.4f, pickupRight = WIDTH - 50.0f;
+};
+
+// Power-up spawn band for the current level (set from its terrain pattern)
+float powerUpZoneLeft = 50.0f;
+float powerUpZoneRight = WIDTH - 50.0f;
+
+// A generated tower: everything initGame() needs that depends on the seed
+struct Level {
+    uint32_t seed = 0;
+    TerrainPattern pattern = MIDDLE_FOCUSED;
+    std::vector<Platform> platforms;
+    std::vector<Collectable> collectables;
+    int mainPathPlatformCount = 0;
+    float powerUpZoneLeft = 50.0f, powerUpZoneRight = WIDTH - 50.0f;
+    int repairSteps = 0;    // Step platforms the validator had to add
+    bool climbable = false; // Door reachable from the ground after repair
+    
+    size_t memoryBytes() const {
+        return sizeof(Level) + platforms.capacity() * sizeof(Platform) + collectables.capacity() * sizeof(Collectable);
+    }
+};
+
+// Per-level random stream, so generation is reproducible from the seed and
+// doesn't touch the shared rand() state (levels are built on a worker thread)
+struct LevelRandom {
+    uint32_t state;
+    explicit LevelRandom(uint32_t seed) {
+        // Scramble the seed so consecutive seeds give unrelated towers
+        uint32_t z = seed + 0x9E3779B9u;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        state = (z ^ (z >> 16)) | 1u;
+    }
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int below(int n) { return n > 0 ? (int)(next() % (uint32_t)n) : 0; }
+};
+
+// Reachability between platforms from the analytic jump arc. Conservative: the
+// jump starts from rest (no run-up) and never uses the double jump power-up.
+const float JUMP_APEX_RISE = PLAYER_JUMP_VELOCITY * PLAYER_JUMP_VELOCITY / (2.0f * PLAYER_GRAVITY);
+const int MAX_REPAIR_STEPS = 8;
+
+// Horizontal distance covered in t seconds accelerating from rest
+float horizontalReach(float t) {
+    float rampTime = PLAYER_MAX_SPEED / PLAYER_ACCELERATION;
+    if (t <= rampTime) return 0.5f * PLAYER_ACCELERATION * t * t;
+    return 0.5f * PLAYER_MAX_SPEED * rampTime + PLAYER_MAX_SPEED * (t - rampTime);
+}
+
+// Can a player standing on one platform land on top of the other? Platforms are
+// one-way (only landing is resolved), so rising through the target is allowed.
+bool canJumpBetween(const Platform& from, const Platform& to) {
+    float rise = (to.y + to.height) - (from.y + from.height);
+    if (rise > JUMP_APEX_RISE) return false;
+    
+    // Gap between the player x ranges that overlap each platform
+    float gap = std::max({0.0f, (to.x - PLAYER_WIDTH) - (from.x + from.width),
+                          (from.x - PLAYER_WIDTH) - (to.x + to.width)});
+    if (gap == 0.0f) return true;
+    
+    // Time until the falling player's feet come back down to the target's top
+    float airTime = (PLAYER_JUMP_VELOCITY + sqrtf(PLAYER_JUMP_VELOCITY * PLAYER_JUMP_VELOCITY - 2.0f * PLAYER_GRAVITY * rise)) / PLAYER_GRAVITY;
+    return horizontalReach(airTime) >= gap;
+}
+
+// Flood the jump graph from the ground platform; true if the door platform is reached
+bool findReachablePlatforms(const std::vector<Platform>& platforms, int doorIndex, std::vector<char>& reached) {
+    int count = platforms.size();
+    reached.assign(count, 0);
+    std::vector<int> pending = {0};
+    reached[0] = 1;
+    while (!pending.empty()) {
+        int from = pending.back();
+        pending.pop_back();
+        for (int to = 0; to < count; to++) {
+            if (!reached[to] && canJumpBetween(platforms[from], platforms[to])) {
+                reached[to] = 1;
+                pending.push_back(to);
+            }
+        }
+    }
+    return reached[doorIndex];
+}
+
+bool levelIsClimbable(const Level& level) {
+    std::vector<char> reached;
+    return findReachablePlatforms(level.platforms, level.mainPathPlatformCount - 1, reached);
+}
+
+// Make the door reachable by adding step platforms: each one goes halfway between
+// the lowest stranded path platform and the highest reachable platform below it,
+// halving the rise and gap, so a few steps always bridge a broken layout.
+// Returns the number of steps added (appended after the main path).
+int repairClimbingPath(std::vector<Platform>& platforms, int mainPathPlatformCount) {
+    int doorIndex = mainPathPlatformCount - 1;
+    float doorTop = platforms[doorIndex].y + platforms[doorIndex].height;
+    std::vector<char> reached;
+    int steps = 0;
+    while (steps < MAX_REPAIR_STEPS && !findReachablePlatforms(platforms, doorIndex, reached)) {
+        int target = doorIndex;
+        for (int i = 1; i < doorIndex; i++) {
+            float top = platforms[i].y + platforms[i].height;
+            if (!reached[i] && top <= doorTop && top < platforms[target].y + platforms[target].height) target = i;
+        }
+        float targetTop = platforms[target].y + platforms[target].height;
+        
+        int source = 0;
+        for (int i = 1; i < (int)platforms.size(); i++) {
+            float top = platforms[i].y + platforms[i].height;
+            if (reached[i] && top <= targetTop && top > platforms[source].y + platforms[source].height) source = i;
+        }
+        
+        const Platform& from = platforms[source];
+        const Platform& to = platforms[target];
+        float stepWidth = 100.0f;
+        float centerX = (from.x + from.width / 2 + to.x + to.width / 2) / 2;
+        float top = (from.y + from.height + targetTop) / 2;
+        float stepX = std::max(0.0f, std::min(WIDTH - stepWidth, roundf(centerX - stepWidth / 2)));
+        platforms.push_back({stepX, roundf(top) - 15, stepWidth, 15, true});
+        steps++;
+    }
+    return steps;
+}
+
+// Generate a tower shaped by a terrain pattern policy
+template <typename Pattern>
+void generatePatternLevel(Level& level, LevelRandom& rng) {
+    std::vector<Platform>& platforms = level.platforms;
+    std::vector<Collectable>& collectables = level.collectables;
+    
+    // Create platforms with different sizes
+    platforms.clear();
+    
+    // Ground platform
+    platforms.push_back({0, 80, WIDTH, 20, true});
+    
+    // Level platforms with challenging, varied generation
+    float platformY = 135; // Start slightly higher
+    const int baseWidths[4] = {50, 100, 150, 200};
+    for (int i = 0; i < 25; i++) { // More platforms for increased height
+        // Pick one of the 4 main lengths with variation
+        int w = baseWidths[rng.below(4)];
+        int jitter = rng.below(21) - 10; // -10..+10 for more variation
+        float platformWidth = std::max(40, w + jitter);
+        
+        // Generate platform position using edge-to-edge offset rule (±50)
+        float platformX;
+        if (i == 0) {
+            platformX = WIDTH / 2 - platformWidth / 2; // Center first platform
+        } else {
+            const Platform& prev = platforms.back();
+            float prevLeft = prev.x;
+            float prevRight = prev.x + prev.width;
+            // Randomly branch left/right, leaning toward the pattern's focus column
+            bool focusIsRight = prevLeft + prev.width / 2.0f < Pattern::focusX;
+            bool attachRight = (rng.below(100) < Pattern::towardFocusPercent) == focusIsRight;
+            float minLeft, maxLeft;
+            if (attachRight) {
+                // New left edge within ±50 of previous right edge
+                minLeft = prevRight - 50.0f;
+                maxLeft = prevRight + 50.0f;
+            } else {
+                // New right edge within ±50 of previous left edge
+                minLeft = (prevLeft - 50.0f) - platformWidth;
+                maxLeft = (prevLeft + 50.0f) - platformWidth;
+            }
+            // Clamp to screen bounds
+            minLeft = std::max(0.0f, minLeft);
+            maxLeft = std::min((float)(WIDTH - platformWidth), maxLeft);
+            
+            if (minLeft <= maxLeft) {
                 if (maxLeft - minLeft < 1.0f) platformX = minLeft;
-                else platformX = minLeft + (rand() % (int)(maxLeft - minLeft + 1));
+                else platformX = minLeft + rng.below((int)(maxLeft - minLeft + 1));
             } else {
                 // Fallback: near previous center within ±50
                 float prevCenter = prev.x + prev.width / 2.0f;
@@ -249,39 +1717,1455 @@ void initGame() {
                 platformX = (fallbackMin + fallbackMax) * 0.5f;
             }
         }
-        
-        platforms.push_back({platformX, platformY, platformWidth, 15, true});
-        // Vertical spacing tuned for reachability
-        platformY += 45 + rand() % 30; // 45..74
+        
+        platforms.push_back({roundf(platformX), platformY, platformWidth, 15, true}); // Whole pixels pack losslessly
+        // Vertical spacing tuned for reachability
+        platformY += 45 + rng.below(30); // 45..74
+    }
+    
+    // Add final platform near the door at the top
+    float doorPlatformY = HEIGHT - 200; // Platform just below door
+    float doorPlatformX = WIDTH / 2 - 60; // Centered under door
+    platforms.push_back({doorPlatformX, doorPlatformY, 120, 15, true});
+    int mainPathPlatformCount = platforms.size();
+    level.mainPathPlatformCount = mainPathPlatformCount;
+    
+    // Check the climb and bridge any gap the rules above left
+    level.repairSteps = repairClimbingPath(platforms, mainPathPlatformCount);
+    level.climbable = levelIsClimbable(level);
+    
+    // Path platforms that are on screen and below the door (anchors for stress-mode extras)
+    int visiblePath = 1;
+    while (visiblePath < mainPathPlatformCount - 1 && platforms[visiblePath].y < doorPlatformY) visiblePath++;
+    
+    // Stress mode: scatter extra platforms around the rows of the climbing path
+    int extraPlatforms = (int)(25 * stress.platforms) - 25;
+    for (int i = 0; i < extraPlatforms; i++) {
+        float anchorY = platforms[1 + rng.below(visiblePath - 1)].y;
+        int w = baseWidths[rng.below(4)];
+        float platformWidth = std::max(40, w + rng.below(21) - 10);
+        float platformX = rng.below((int)(WIDTH - platformWidth));
+        float platformY = anchorY + rng.below(31) - 15;
+        platforms.push_back({platformX, platformY, platformWidth, 15, true});
+    }
+    
+    // Create collectables (at least 5) - Place them near platforms
+    collectables.clear();
+    int collectableCount = (int)(10 * stress.coins);
+    for (int i = 0; i < collectableCount; i++) { // More collectables for bigger game
+        if (i >= 10) {
+            // Stress mode extras: above a random on-screen platform
+            const Platform& plat = platforms[1 + rng.below(visiblePath - 1)];
+            float x = plat.x + rng.below((int)plat.width);
+            float y = plat.y + plat.height + 20 + rng.below(30);
+            collectables.push_back({x, y, false, 0.0f, i});
+        } else if (i < mainPathPlatformCount - 2) { // Avoid last platform (door platform)
+            // Place collectables near platforms for easier collection
+            float platX = platforms[i + 1].x + platforms[i + 1].width / 2;
+            float platY = platforms[i + 1].y + platforms[i + 1].height + 20;
+            float x = roundf(platX + Pattern::coinShift + (rng.below(60) - 30)); // Small offset from platform center
+            float y = platY + rng.below(30);
+            collectables.push_back({x, y, false, 0.0f, i});
+        } else {
+            // Backup placement for extra collectables in the pattern's pickup band
+            float x = Pattern::pickupLeft + rng.below((int)(Pattern::pickupRight - Pattern::pickupLeft));
+            float y = 250 + i * 60 + rng.below(30);
+            collectables.push_back({x, y, false, 0.0f, i});
+        }
+    }
+    
+    level.powerUpZoneLeft = Pattern::pickupLeft;
+    level.powerUpZoneRight = Pattern::pickupRight;
+}
+
+// One generator instantiation per pattern, indexed by TerrainPattern
+void (*const terrainGenerators[])(Level&, LevelRandom&) = {
+    generatePatternLevel<MiddleFocusedTerrain>,
+    generatePatternLevel<LeftFocusedTerrain>,
+    generatePatternLevel<RightFocusedTerrain>,
+};
+static_assert(sizeof(terrainGenerators) / sizeof(terrainGenerators[0]) == TERRAIN_PATTERN_COUNT,
+              "one generator per terrain pattern");
+
+// Generate the tower for a seed. Pure: reads only the (startup-time) stress settings.
+void generateLevel(Level& level, uint32_t seed) {
+    LevelRandom rng(seed);
+    level.seed = seed;
+    level.pattern = (TerrainPattern)rng.below(TERRAIN_PATTERN_COUNT);
+    terrainGenerators[level.pattern](level, rng);
+}
+
+// Compact level encoding for banks and streaming: platforms and coins as 16-bit
+// integer pixel coordinates, platform widths as a one-byte size code, and
+// platform activity / coin collection in bitsets after the records. Generated
+// levels are on whole pixels, so the encoding is lossless for them.
+//
+// Layout: PackedLevelHeader, platformCount PackedPlatform, coinCount PackedCoin,
+// then the platform-active and coin-collected bitsets, padded to 4 bytes.
+struct PackedLevelHeader {
+    uint8_t pattern;
+    uint8_t repairSteps;
+    uint16_t mainPathPlatformCount;
+    uint16_t platformCount;
+    uint16_t coinCount;
+    int16_t powerUpZoneLeft, powerUpZoneRight;
+};
+
+struct PackedPlatform {
+    int16_t x, y;
+    uint8_t widthCode; // See platformWidthCode()
+    uint8_t height;
+};
+
+struct PackedCoin {
+    int16_t x, y;
+};
+
+static_assert(sizeof(PackedLevelHeader) == 12, "PackedLevelHeader layout");
+static_assert(sizeof(PackedPlatform) == 6, "PackedPlatform layout");
+static_assert(sizeof(PackedCoin) == 4, "PackedCoin layout");
+
+// Width codes 0..83 are the generator's size classes (50/100/150/200) with
+// jitter -10..+10; 84..255 cover other widths (ground, door, repair steps) in
+// steps of 5px up to 855px
+const int WIDTH_CLASS_CODES = 4 * 21;
+
+constexpr std::array<uint16_t, 256> makePlatformWidthTable() {
+    std::array<uint16_t, 256> table = {};
+    for (int code = 0; code < 256; code++) {
+        table[code] = code < WIDTH_CLASS_CODES ? (code / 21 + 1) * 50 + code % 21 - 10 : (code - WIDTH_CLASS_CODES) * 5;
+    }
+    return table;
+}
+constexpr std::array<uint16_t, 256> platformWidthTable = makePlatformWidthTable();
+
+// Returns -1 if the width has no code
+int platformWidthCode(float width) {
+    int w = (int)width;
+    if (w != width) return -1;
+    int sizeClass = (w + 25) / 50 - 1;
+    int jitter = w - (sizeClass + 1) * 50;
+    if (sizeClass >= 0 && sizeClass < 4 && jitter >= -10 && jitter <= 10) return sizeClass * 21 + jitter + 10;
+    if (w % 5 == 0 && w / 5 <= 255 - WIDTH_CLASS_CODES) return WIDTH_CLASS_CODES + w / 5;
+    return -1;
+}
+
+bool fitsPackedCoordinate(float v) {
+    return v == (float)(int)v && v >= INT16_MIN && v <= INT16_MAX;
+}
+
+size_t packedLevelSize(int platformCount, int coinCount) {
+    size_t size = sizeof(PackedLevelHeader) + platformCount * sizeof(PackedPlatform) + coinCount * sizeof(PackedCoin)
+                + (platformCount + 7) / 8 + (coinCount + 7) / 8;
+    return (size + 3) & ~(size_t)3;
+}
+
+// Append a level's packed form; false (and nothing appended) if it doesn't fit
+bool packLevel(const Level& level, std::vector<unsigned char>& out) {
+    int platformCount = level.platforms.size(), coinCount = level.collectables.size();
+    if (platformCount > UINT16_MAX || coinCount > UINT16_MAX) return false;
+    for (const Platform& p : level.platforms) {
+        if (!fitsPackedCoordinate(p.x) || !fitsPackedCoordinate(p.y) || platformWidthCode(p.width) < 0 ||
+            p.height != (float)(uint8_t)p.height) return false;
+    }
+    for (const Collectable& c : level.collectables) {
+        if (!fitsPackedCoordinate(c.x) || !fitsPackedCoordinate(c.y)) return false;
+    }
+    
+    size_t start = out.size();
+    out.resize(start + packedLevelSize(platformCount, coinCount), 0);
+    unsigned char* at = out.data() + start;
+    PackedLevelHeader header = {(uint8_t)level.pattern, (uint8_t)level.repairSteps, (uint16_t)level.mainPathPlatformCount,
+                                (uint16_t)platformCount, (uint16_t)coinCount,
+                                (int16_t)level.powerUpZoneLeft, (int16_t)level.powerUpZoneRight};
+    memcpy(at, &header, sizeof(header));
+    at += sizeof(header);
+    for (const Platform& p : level.platforms) {
+        PackedPlatform packed = {(int16_t)p.x, (int16_t)p.y, (uint8_t)platformWidthCode(p.width), (uint8_t)p.height};
+        memcpy(at, &packed, sizeof(packed));
+        at += sizeof(packed);
+    }
+    for (const Collectable& c : level.collectables) {
+        PackedCoin packed = {(int16_t)c.x, (int16_t)c.y};
+        memcpy(at, &packed, sizeof(packed));
+        at += sizeof(packed);
+    }
+    for (int i = 0; i < platformCount; i++) at[i / 8] |= level.platforms[i].active << (i % 8);
+    at += (platformCount + 7) / 8;
+    for (int i = 0; i < coinCount; i++) at[i / 8] |= level.collectables[i].collected << (i % 8);
+    return true;
+}
+
+// Decode a packed level into the runtime representation
+bool unpackLevel(const unsigned char* data, size_t size, uint32_t seed, Level& level) {
+    PackedLevelHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.pattern >= TERRAIN_PATTERN_COUNT || header.mainPathPlatformCount < 2 ||
+        header.mainPathPlatformCount > header.platformCount ||
+        size < packedLevelSize(header.platformCount, header.coinCount)) {
+        return false;
+    }
+    level.seed = seed;
+    level.pattern = (TerrainPattern)header.pattern;
+    level.mainPathPlatformCount = header.mainPathPlatformCount;
+    level.repairSteps = header.repairSteps;
+    level.powerUpZoneLeft = header.powerUpZoneLeft;
+    level.powerUpZoneRight = header.powerUpZoneRight;
+    level.climbable = true; // Only climbable levels are stored
+    
+    const unsigned char* platformData = data + sizeof(header);
+    const unsigned char* coinData = platformData + header.platformCount * sizeof(PackedPlatform);
+    const unsigned char* activeBits = coinData + header.coinCount * sizeof(PackedCoin);
+    const unsigned char* collectedBits = activeBits + (header.platformCount + 7) / 8;
+    
+    level.platforms.resize(header.platformCount);
+    for (int i = 0; i < header.platformCount; i++) {
+        PackedPlatform p;
+        memcpy(&p, platformData + i * sizeof(PackedPlatform), sizeof(p));
+        level.platforms[i] = {(float)p.x, (float)p.y, (float)platformWidthTable[p.widthCode], (float)p.height,
+                              (bool)((activeBits[i / 8] >> (i % 8)) & 1)};
+    }
+    level.collectables.resize(header.coinCount);
+    for (int i = 0; i < header.coinCount; i++) {
+        PackedCoin c;
+        memcpy(&c, coinData + i * sizeof(PackedCoin), sizeof(c));
+        level.collectables[i] = {(float)c.x, (float)c.y, (bool)((collectedBits[i / 8] >> (i % 8)) & 1), 0.0f, i};
+    }
+    return true;
+}
+
+// Pool of pre-generated levels, refilled by scheduler tasks while the current
+// game runs so a restart swaps in a ready tower instead of generating one
+struct LevelPool {
+    static const int TARGET = 3;                  // Levels kept ready
+    static const size_t MAX_BYTES = 4 << 20;      // Memory cap (one level is always allowed)
+    std::mutex mutex;
+    std::deque<Level> ready;
+    size_t readyBytes = 0;
+    int generating = 0;                           // Refill tasks in flight
+    std::atomic<uint32_t> nextSeed{0};
+    
+    bool full() const {
+        return (int)ready.size() + generating >= TARGET || (!ready.empty() && readyBytes >= MAX_BYTES);
+    }
+    
+    // Start generation tasks until the pool will be full; mutex held
+    void refill() {
+        while (!full()) {
+            generating++;
+            tasks.spawn([this] {
+                Level level;
+                generate(level);
+                std::lock_guard<std::mutex> lock(mutex);
+                generating--;
+                readyBytes += level.memoryBytes();
+                ready.push_back(std::move(level));
+                refill();
+            });
+        }
+    }
+    
+    // Hand out a ready level, or generate one on the spot if the pool is empty
+    void take(Level& level) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!ready.empty()) {
+            level = std::move(ready.front());
+            ready.pop_front();
+            readyBytes -= level.memoryBytes();
+            refill();
+            return;
+        }
+        lock.unlock();
+        generate(level);
+    }
+    
+    // Seeds whose layout can't be repaired are rejected and the next one is used
+    void generate(Level& level) {
+        for (int attempt = 0; attempt < 16; attempt++) {
+            generateLevel(level, nextSeed++);
+            if (level.climbable) return;
+        }
+    }
+};
+
+// Never destroyed: a refill task may still be running at exit
+LevelPool& levelPool = *new LevelPool();
+
+void startLevelPool() {
+    levelPool.nextSeed = (uint32_t)time(NULL);
+    std::lock_guard<std::mutex> lock(levelPool.mutex);
+    levelPool.refill();
+}
+
+// Headless generator statistics (--validate-seeds): generate and check seeds
+// 0..N-1 across threads and report how often layouts needed repair or failed
+struct SeedValidation {
+    int seedCount = 0;
+    int threads = 0; // 0 = one per hardware thread
+} seedValidation;
+
+int runSeedValidation() {
+    const int chunk = 4096;
+    std::atomic<long long> repairedLevels{0}, repairSteps{0}, unclimbable{0}, totalPlatforms{0};
+    std::atomic<long long> packMismatches{0}, packedBytes{0};
+    std::mutex patternMutex;
+    long long patternLevels[TERRAIN_PATTERN_COUNT] = {};
+    double patternCenterSum[TERRAIN_PATTERN_COUNT] = {}; // Mean x of the climbing path
+    
+    // One task per chunk of seeds; totals are merged once per chunk
+    auto validateSeeds = [&](int first, int last) {
+        Level level, unpacked;
+        std::vector<unsigned char> packed;
+        long long repaired = 0, steps = 0, failed = 0, platformCount = 0, mismatches = 0, bytes = 0;
+        long long levels[TERRAIN_PATTERN_COUNT] = {};
+        double centerSum[TERRAIN_PATTERN_COUNT] = {};
+        for (int seed = first; seed < last; seed++) {
+            generateLevel(level, (uint32_t)seed);
+            repaired += level.repairSteps > 0;
+            steps += level.repairSteps;
+            failed += !level.climbable;
+            platformCount += level.platforms.size();
+            
+            // The packed encoding must round-trip generated levels exactly
+            packed.clear();
+            bool same = packLevel(level, packed) && unpackLevel(packed.data(), packed.size(), level.seed, unpacked) &&
+                        unpacked.platforms.size() == level.platforms.size() &&
+                        unpacked.collectables.size() == level.collectables.size();
+            for (size_t i = 0; same && i < level.platforms.size(); i++) {
+                const Platform& a = level.platforms[i];
+                const Platform& b = unpacked.platforms[i];
+                same = a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height && a.active == b.active;
+            }
+            for (size_t i = 0; same && i < level.collectables.size(); i++) {
+                same = level.collectables[i].x == unpacked.collectables[i].x && level.collectables[i].y == unpacked.collectables[i].y;
+            }
+            mismatches += !same;
+            bytes += packed.size();
+            
+            double center = 0.0;
+            for (int i = 1; i < level.mainPathPlatformCount - 1; i++) {
+                center += level.platforms[i].x + level.platforms[i].width / 2;
+            }
+            levels[level.pattern]++;
+            centerSum[level.pattern] += center / std::max(1, level.mainPathPlatformCount - 2);
+        }
+        std::lock_guard<std::mutex> lock(patternMutex);
+        for (int p = 0; p < TERRAIN_PATTERN_COUNT; p++) {
+            patternLevels[p] += levels[p];
+            patternCenterSum[p] += centerSum[p];
+        }
+        repairedLevels += repaired;
+        packMismatches += mismatches;
+        packedBytes += bytes;
+        repairSteps += steps;
+        unclimbable += failed;
+        totalPlatforms += platformCount;
+    };
+    
+    double start = nowMs();
+    tasks.parallelFor(0, seedValidation.seedCount, chunk, validateSeeds);
+    double elapsedMs = std::max(nowMs() - start, 0.001);
+    
+    double n = std::max(1, seedValidation.seedCount);
+    printf("Validated %d seeds on %d threads in %.1f ms (%.0f seeds/minute)\n",
+           seedValidation.seedCount, tasks.workerCount() + 1, elapsedMs, seedValidation.seedCount * 60000.0 / elapsedMs);
+    printf("  needed repair:      %lld (%.3f%%), %.2f steps per repaired level\n", repairedLevels.load(),
+           100.0 * repairedLevels / n, repairedLevels ? (double)repairSteps / repairedLevels : 0.0);
+    printf("  unclimbable after:  %lld (%.3f%%)\n", unclimbable.load(), 100.0 * unclimbable / n);
+    printf("  platforms per level: %.2f\n", totalPlatforms / n);
+    printf("  packed size:        %.1f bytes per level, %lld round-trip mismatches\n", packedBytes / n, packMismatches.load());
+    const char* patternNames[TERRAIN_PATTERN_COUNT] = {"middle", "left", "right"};
+    for (int p = 0; p < TERRAIN_PATTERN_COUNT; p++) {
+        printf("  %-6s focused: %lld levels, mean path x %.1f\n", patternNames[p], patternLevels[p],
+               patternLevels[p] ? patternCenterSum[p] / patternLevels[p] : 0.0);
+    }
+    return unclimbable == 0 && packMismatches == 0 ? 0 : 1;
+}
+
+// Level scoring for the seed bank: the easiest route (fewest jumps) from the
+// ground to the door, and how close each of its jumps is to the limit
+struct LevelScore {
+    float difficulty = 0.0f; // 0 = every jump trivial ... 1 = every jump at the limit
+    int pathJumps = 0;       // Jumps on the shortest climbing route
+    float coinSpread = 0.0f; // Standard deviation of coin x
+};
+
+// How hard a single jump is: the larger of the rise and the horizontal gap as a
+// fraction of what the arc allows, plus a little for narrow landings
+float jumpTightness(const Platform& from, const Platform& to) {
+    float rise = (to.y + to.height) - (from.y + from.height);
+    float gap = std::max({0.0f, (to.x - PLAYER_WIDTH) - (from.x + from.width),
+                          (from.x - PLAYER_WIDTH) - (to.x + to.width)});
+    float clampedRise = std::max(0.0f, std::min(rise, JUMP_APEX_RISE));
+    float airTime = (PLAYER_JUMP_VELOCITY + sqrtf(PLAYER_JUMP_VELOCITY * PLAYER_JUMP_VELOCITY - 2.0f * PLAYER_GRAVITY * clampedRise)) / PLAYER_GRAVITY;
+    float riseFraction = clampedRise / JUMP_APEX_RISE;
+    float gapFraction = gap / horizontalReach(airTime);
+    float narrowLanding = 1.0f - std::min(1.0f, to.width / 200.0f);
+    return std::min(1.0f, std::max(riseFraction, gapFraction) * 0.85f + narrowLanding * 0.15f);
+}
+
+void scoreLevel(const Level& level, LevelScore& score) {
+    const std::vector<Platform>& platforms = level.platforms;
+    int count = platforms.size();
+    int door = level.mainPathPlatformCount - 1;
+    
+    // Breadth-first search over the jump graph for the fewest-jumps route
+    std::vector<int> parent(count, -1);
+    std::vector<int> queue = {0};
+    parent[0] = 0;
+    for (size_t head = 0; head < queue.size() && parent[door] < 0; head++) {
+        int from = queue[head];
+        for (int to = 0; to < count; to++) {
+            if (parent[to] < 0 && canJumpBetween(platforms[from], platforms[to])) {
+                parent[to] = from;
+                queue.push_back(to);
+            }
+        }
+    }
+    
+    score = LevelScore();
+    if (parent[door] >= 0) {
+        float tightnessSum = 0.0f, tightest = 0.0f;
+        for (int at = door; at != 0; at = parent[at]) {
+            float t = jumpTightness(platforms[parent[at]], platforms[at]);
+            tightnessSum += t;
+            tightest = std::max(tightest, t);
+            score.pathJumps++;
+        }
+        score.difficulty = 0.6f * tightnessSum / score.pathJumps + 0.4f * tightest;
+    } else {
+        score.difficulty = 1.0f;
+    }
+    
+    double sum = 0.0, sumSquares = 0.0;
+    for (const Collectable& coin : level.collectables) {
+        sum += coin.x;
+        sumSquares += (double)coin.x * coin.x;
+    }
+    if (!level.collectables.empty()) {
+        double mean = sum / level.collectables.size();
+        score.coinSpread = (float)sqrt(std::max(0.0, sumSquares / level.collectables.size() - mean * mean));
+    }
+}
+
+// Seed bank: curated levels in one memory-mapped file. Layout: SeedBankHeader,
+// then levelCount SeedBankEntry records sorted by difficulty, then the packed
+// levels the entries point at. Built offline with --build-seed-bank.
+const char SEED_BANK_MAGIC[4] = {'I', 'T', 'S', 'B'};
+const uint32_t SEED_BANK_VERSION = 2;
+
+struct SeedBankHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t levelCount;
+    uint32_t reserved;
+};
+
+struct SeedBankEntry {
+    float difficulty;
+    uint32_t seed;
+    uint16_t pathJumps;
+    uint16_t coinSpread;   // Pixels
+    uint32_t layoutOffset; // From the start of the file
+    uint32_t layoutSize;
+};
+
+static_assert(sizeof(SeedBankEntry) == 20, "SeedBankEntry layout");
+
+// Read-only view of a seed bank file
+struct SeedBank {
+    const unsigned char* base = nullptr;
+    size_t length = 0;
+    const SeedBankEntry* entries = nullptr;
+    uint32_t levelCount = 0;
+    
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SeedBankHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return false;
+        
+        const SeedBankHeader* header = (const SeedBankHeader*)mapping;
+        if (memcmp(header->magic, SEED_BANK_MAGIC, 4) != 0 || header->version != SEED_BANK_VERSION ||
+            sizeof(SeedBankHeader) + (uint64_t)header->levelCount * sizeof(SeedBankEntry) > (uint64_t)info.st_size) {
+            munmap(mapping, info.st_size);
+            return false;
+        }
+        base = (const unsigned char*)mapping;
+        length = info.st_size;
+        entries = (const SeedBankEntry*)(base + sizeof(SeedBankHeader));
+        levelCount = header->levelCount;
+        return true;
+    }
+    
+    // The banked level closest above a difficulty score (binary search)
+    const SeedBankEntry* findDifficulty(float difficulty) const {
+        if (levelCount == 0) return nullptr;
+        const SeedBankEntry* end = entries + levelCount;
+        const SeedBankEntry* found = std::lower_bound(entries, end, difficulty,
+            [](const SeedBankEntry& entry, float value) { return entry.difficulty < value; });
+        return found == end ? found - 1 : found;
+    }
+    
+    // The level at a difficulty rank: 0 = easiest in the bank, 1 = hardest
+    const SeedBankEntry* findPercentile(float fraction) const {
+        if (levelCount == 0) return nullptr;
+        return &entries[(uint32_t)(fraction * (levelCount - 1) + 0.5f)];
+    }
+    
+    bool load(const SeedBankEntry* entry, Level& level) const {
+        if (!entry || (uint64_t)entry->layoutOffset + entry->layoutSize > length) return false;
+        return unpackLevel(base + entry->layoutOffset, entry->layoutSize, entry->seed, level);
+    }
+} seedBank;
+
+// Curated level selection (--level); the same banked tower is replayed on every restart
+struct BankedLevelChoice {
+    bool enabled = false;
+    bool byRank = true;       // easy/medium/hard pick by rank in the bank
+    float difficulty = 0.5f;  // Rank (0..1), or a difficulty score when !byRank
+    std::string bankPath; // Empty: levels.bank next to the executable, then the cwd
+    Level level;
+} bankedLevel;
+
+// Offline seed bank builder (--build-seed-bank): generate, validate and score
+// seeds across threads, then write them sorted by difficulty
+struct SeedBankBuild {
+    std::string path;
+    int seedCount = 20000;
+} seedBankBuild;
+
+int buildSeedBank() {
+    struct Banked {
+        SeedBankEntry entry;
+        std::vector<unsigned char> layout;
+    };
+    const int chunk = 1024;
+    int chunkCount = (seedBankBuild.seedCount + chunk - 1) / chunk;
+    std::vector<std::vector<Banked>> results(chunkCount); // One per chunk of seeds, so no locking
+    std::atomic<int> unpackable{0};
+    
+    double start = nowMs();
+    tasks.parallelFor(0, chunkCount, 1, [&](int firstChunk, int lastChunk) {
+        Level level;
+        LevelScore score;
+        for (int c = firstChunk; c < lastChunk; c++) {
+            int last = std::min(seedBankBuild.seedCount, (c + 1) * chunk);
+            for (int seed = c * chunk; seed < last; seed++) {
+                generateLevel(level, (uint32_t)seed);
+                if (!level.climbable) continue;
+                scoreLevel(level, score);
+                Banked banked;
+                banked.entry = {score.difficulty, (uint32_t)seed, (uint16_t)score.pathJumps,
+                                (uint16_t)std::min(65535.0f, score.coinSpread), 0, 0};
+                if (!packLevel(level, banked.layout)) {
+                    unpackable++;
+                    continue;
+                }
+                results[c].push_back(std::move(banked));
+            }
+        }
+    });
+    
+    std::vector<Banked> levels;
+    for (std::vector<Banked>& part : results) {
+        for (Banked& banked : part) levels.push_back(std::move(banked));
+    }
+    std::sort(levels.begin(), levels.end(), [](const Banked& a, const Banked& b) {
+        return a.entry.difficulty < b.entry.difficulty || (a.entry.difficulty == b.entry.difficulty && a.entry.seed < b.entry.seed);
+    });
+    
+    // Lay out the layouts after the index, in difficulty order
+    uint64_t offset = sizeof(SeedBankHeader) + levels.size() * sizeof(SeedBankEntry);
+    for (Banked& banked : levels) {
+        banked.entry.layoutOffset = (uint32_t)offset;
+        banked.entry.layoutSize = banked.layout.size();
+        offset += banked.layout.size();
+    }
+    if (offset > UINT32_MAX) {
+        std::cerr << "Seed bank too large; use fewer seeds" << std::endl;
+        return 1;
+    }
+    
+    FILE* file = fopen(seedBankBuild.path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Cannot write " << seedBankBuild.path << std::endl;
+        return 1;
+    }
+    SeedBankHeader header = {};
+    memcpy(header.magic, SEED_BANK_MAGIC, 4);
+    header.version = SEED_BANK_VERSION;
+    header.levelCount = levels.size();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const Banked& banked : levels) ok = ok && fwrite(&banked.entry, sizeof(SeedBankEntry), 1, file) == 1;
+    for (const Banked& banked : levels) ok = ok && fwrite(banked.layout.data(), 1, banked.layout.size(), file) == banked.layout.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Failed writing " << seedBankBuild.path << std::endl;
+        return 1;
+    }
+    
+    printf("Banked %zu of %d seeds in %.1f ms (%.1f KB, %.1f bytes per level)\n", levels.size(), seedBankBuild.seedCount,
+           nowMs() - start, offset / 1024.0, levels.empty() ? 0.0 : (double)offset / levels.size());
+    if (unpackable > 0) printf("  %d levels skipped: not representable in the packed format\n", unpackable.load());
+    if (!levels.empty()) {
+        auto at = [&](double q) { return levels[(size_t)(q * (levels.size() - 1))].entry.difficulty; };
+        printf("  difficulty: min %.3f, 25%% %.3f, median %.3f, 75%% %.3f, max %.3f\n",
+               at(0.0), at(0.25), at(0.5), at(0.75), at(1.0));
+    }
+    return 0;
+}
+
+// Swept AABB test: the earliest fraction (0..1) of a move by (dx, dy) at which
+// box 1 overlaps box 2, or -1 if it never does. Unlike checkCollision() on the
+// end position, a long frame can't carry one box through the other
+double sweptCollisionTime(double x1, double y1, double w1, double h1, double dx, double dy,
+                          double x2, double y2, double w2, double h2) {
+    double enter = 0.0, leave = 1.0;
+    // Narrow [enter, leave] to the part of the move overlapping on one axis
+    auto clip = [&](double start, double size, double delta, double other, double otherSize) {
+        double low = other - size - start;  // delta * t must stay above this...
+        double high = other + otherSize - start; // ...and below this
+        if (delta == 0.0) return low < 0.0 && high > 0.0;
+        double t0 = low / delta, t1 = high / delta;
+        enter = std::max(enter, std::min(t0, t1));
+        leave = std::min(leave, std::max(t0, t1));
+        return enter < leave;
+    };
+    if (!clip(x1, w1, dx, x2, w2) || !clip(y1, h1, dy, y2, h2)) return -1.0;
+    return enter;
+}
+
+// Gameplay rules shared by update() and the batch simulator, so the self-checks
+// run the game's own rules rather than a copy of them
+const float LAVA_BASE_SPEED = 0.35f;     // Rise speed at the start of a run, before LAVA_RISE_SCALE
+const float LAVA_SPEED_GROWTH = 0.008f;  // Added to the rise speed per second of play
+const float LAVA_RISE_SCALE = 9.0f;
+const float ROCK_FALL_SPEED = 200.0f;
+const float ROCK_SIZE = 20.0f;           // Rocks and coins are boxes of this size around their centre
+const float COIN_SIZE = 20.0f;
+const float ROCK_GONE_Y = -20.0f;        // Rocks leave play below this
+
+// Lava rise over the step ending at `time`. The speed grows linearly, so its value
+// mid-step gives the exact rise for any step length
+template <typename Real>
+Real lavaRise(Real time, Real dt) {
+    return (LAVA_BASE_SPEED + (time - dt / 2) * LAVA_SPEED_GROWTH) * LAVA_RISE_SCALE * dt;
+}
+
+// Seconds until the next rock, from a roll in [0, 80): 0.8s - 1.6s, scaled by stress mode
+float rockSpawnInterval(int roll) {
+    return (0.8f + roll / 100.0f) / stress.rockRate;
+}
+
+// Whether a falling rock meets the player during a step, swept in the rock's
+// frame over the player's move plus the rock's fall
+template <typename Real>
+bool rockHitsPlayer(Real startX, Real startY, Real x, Real y, Real rockX, Real rockY, Real dt) {
+    return sweptCollisionTime(startX, startY, PLAYER_WIDTH, PLAYER_HEIGHT, x - startX, y - startY + ROCK_FALL_SPEED * dt,
+                              rockX - ROCK_SIZE / 2, rockY - ROCK_SIZE / 2, ROCK_SIZE, ROCK_SIZE) >= 0.0;
+}
+
+template <typename Real>
+bool playerTouchesCoin(Real x, Real y, const Collectable& coin) {
+    return x < coin.x + COIN_SIZE / 2 && x + PLAYER_WIDTH > coin.x - COIN_SIZE / 2 &&
+           y < coin.y + COIN_SIZE / 2 && y + PLAYER_HEIGHT > coin.y - COIN_SIZE / 2;
+}
+
+// Jump from the ground, or double jump mid-air when the power-up allows one;
+// returns whether the player jumped
+template <typename Real>
+bool applyJump(Real& velocityY, bool& onGround, bool canDoubleJump, bool& hasDoubleJumped) {
+    if (onGround) {
+        velocityY = PLAYER_JUMP_VELOCITY;
+        onGround = false;
+        return true;
+    }
+    if (canDoubleJump && !hasDoubleJumped) {
+        velocityY = PLAYER_DOUBLE_JUMP_VELOCITY;
+        hasDoubleJumped = true;
+        return true;
+    }
+    return false;
+}
+
+// Player motion for one step. Gravity, and acceleration toward the held
+// direction (-1, 0, 1) up to top speed or damping when none is held, are
+// integrated exactly over the step, so the path doesn't depend on the frame rate
+// and a landing falls in the step that contains it. Lands on the first platform
+// the move touches while falling, so a long frame can't drop the player through
+// one, and coasts with ground damping from that moment. Returns that platform's
+// index, or -1 in the air
+template <typename Real>
+int stepPlayerMotion(Real& x, Real& y, Real& velocityX, Real& velocityY, int direction, bool onGround,
+                     const std::vector<Platform>& platforms, Real dt) {
+    // Horizontal motion over `span` seconds. x is clamped to the walls as it
+    // goes, so a player pressed against one only leaves it once turned around
+    auto moveHorizontally = [&](Real span, bool grounded) {
+        const Real maxX = WIDTH - PLAYER_WIDTH;
+        if (direction != 0) {
+            Real accel = direction * PLAYER_ACCELERATION;
+            if (velocityX * direction < 0) {
+                Real turnTime = std::min(span, -velocityX / accel);
+                x = std::max((Real)0, std::min(maxX, x + (velocityX + accel * turnTime / 2) * turnTime));
+                velocityX += accel * turnTime;
+                span -= turnTime;
+            }
+            // Accelerate until top speed, then hold it
+            Real topSpeed = direction * PLAYER_MAX_SPEED;
+            Real rampTime = std::max((Real)0, std::min(span, (topSpeed - velocityX) / accel));
+            x += (velocityX + accel * rampTime / 2) * rampTime + topSpeed * (span - rampTime);
+            velocityX = rampTime < span ? topSpeed : velocityX + accel * span;
+        } else {
+            // Exponential decay, with the distance it covers over the span
+            Real damping = grounded ? PLAYER_GROUND_DAMPING : PLAYER_AIR_DAMPING;
+            Real decay = -DAMPING_REFERENCE_RATE * std::log(damping);
+            Real kept = std::pow(damping, span * DAMPING_REFERENCE_RATE);
+            if (std::fabs(velocityX * kept) < 5) {
+                // Stop tiny velocities to avoid jitter, where they drop below 5 px/s
+                if (std::fabs(velocityX) > 5) x += (velocityX - std::copysign((Real)5, velocityX)) / decay;
+                velocityX = 0;
+            } else {
+                x += velocityX * (1 - kept) / decay;
+                velocityX *= kept;
+            }
+        }
+        x = std::max((Real)0, std::min(maxX, x));
+    };
+
+    Real startX = x, startY = y, startVelocityX = velocityX, startVelocityY = velocityY;
+    y += (velocityY - PLAYER_GRAVITY * dt / 2) * dt;
+    velocityY -= PLAYER_GRAVITY * dt;
+    moveHorizontally(dt, onGround);
+
+    // Only the falling part of the move can land, so a step that passes the apex
+    // is swept from there
+    Real fromX = startX, fromY = startY;
+    if (startVelocityY > 0) {
+        fromX += (x - startX) * startVelocityY / (PLAYER_GRAVITY * dt);
+        fromY += startVelocityY * startVelocityY / (2 * PLAYER_GRAVITY);
+    }
+    int landing = -1;
+    double landingTime = 2.0;
+    for (int i = 0; velocityY <= 0 && i < (int)platforms.size(); i++) {
+        const Platform& platform = platforms[i];
+        if (!platform.active) continue;
+        double t = sweptCollisionTime(fromX, fromY, PLAYER_WIDTH, PLAYER_HEIGHT, x - fromX, y - fromY,
+                                      platform.x, platform.y, platform.width, platform.height);
+        // Feet ending the step exactly on top land too; the sweep only sees overlap
+        if (t < 0.0 && y == platform.y + platform.height && x < platform.x + platform.width && x + PLAYER_WIDTH > platform.x) t = 1.0;
+        if (t >= 0.0 && t < landingTime && fromY + (y - fromY) * t > platform.y) {
+            landing = i;
+            landingTime = t;
+        }
+    }
+    if (landing >= 0) {
+        Real top = platforms[landing].y + platforms[landing].height;
+        if (!onGround && direction == 0) {
+            // Coast on the ground from the moment the feet reach the top
+            Real fall = std::sqrt(std::max((Real)0, startVelocityY * startVelocityY + 2 * PLAYER_GRAVITY * (startY - top)));
+            Real air = std::max((Real)0, std::min(dt, (startVelocityY + fall) / PLAYER_GRAVITY));
+            x = startX;
+            velocityX = startVelocityX;
+            moveHorizontally(air, false);
+            moveHorizontally(dt - air, true);
+        }
+        y = top;
+        velocityY = 0;
+    }
+    return landing;
+}
+
+// Headless batch simulation. SimState carries the rules of update() that decide
+// how a run plays out: player movement and landings (through stepPlayerMotion),
+// lava, rocks, coins and the power-up timer. stepSim() advances it by a fixed
+// step like the game loop;
+// fastForwardSim() solves for the next event and jumps straight to it
+enum SimAction { SIM_HOLD_LEFT, SIM_HOLD_RIGHT, SIM_RELEASE, SIM_JUMP };
+
+struct SimInput {
+    double time;
+    SimAction action;
+};
+
+struct SimRock {
+    double x, y;
+};
+
+// Doubles throughout, since the stepped reference takes thousands of tiny steps
+struct SimState {
+    double time = 0.0;
+    double x = WIDTH / 2.0, y = 110.0;
+    double velocityX = 0.0, velocityY = 0.0;
+    int direction = 0; // Held movement key: -1 left, 0 none, 1 right
+    int ground = -1;   // Platform being stood on, -1 in the air
+    bool canDoubleJump = false;
+    bool hasDoubleJumped = false;
+    int powerUpType = 0;
+    double powerUpTimer = 0.0;
+    double lavaHeight = 50.0;
+    double rockSpawnTimer = 0.0;
+    std::vector<Platform> platforms;
+    std::vector<Collectable> collectables;
+    std::vector<SimRock> rocks;
+    LevelRandom random{0};
+    size_t nextInput = 0;
+    int lives = 3;
+    bool gameOver = false;
+
+    // Outcome counters, compared between the two simulations
+    int jumps = 0;
+    int platformChanges = 0; // Landings on a platform other than the last one stood on
+    int lastPlatform = -1;
+    int coins = 0;
+    int rockHits = 0;
+    int rocksSpawned = 0;
+};
+
+void standOnSimPlatform(SimState& s, int index) {
+    const Platform& platform = s.platforms[index];
+    s.y = platform.y + platform.height;
+    s.velocityY = 0.0;
+    s.ground = index;
+    s.hasDoubleJumped = false;
+}
+
+void spawnSimRock(SimState& s) {
+    s.rocks.push_back({(double)s.random.below(WIDTH - (int)ROCK_SIZE), (double)HEIGHT});
+    s.rockSpawnTimer += rockSpawnInterval(s.random.below(80));
+    s.rocksSpawned++;
+}
+
+// A rock reached the player: it shatters, and costs a life unless shielded
+void hitSimRock(SimState& s, size_t index) {
+    s.rockHits++;
+    if (s.powerUpType != 1 && --s.lives <= 0) s.gameOver = true;
+    s.rocks.erase(s.rocks.begin() + index);
+}
+
+// Apply every scripted input that is due, as keyboard() would
+void applySimInputs(SimState& s, const std::vector<SimInput>& inputs) {
+    for (; s.nextInput < inputs.size() && inputs[s.nextInput].time <= s.time + 1e-9; s.nextInput++) {
+        switch (inputs[s.nextInput].action) {
+            case SIM_HOLD_LEFT: s.direction = -1; break;
+            case SIM_HOLD_RIGHT: s.direction = 1; break;
+            case SIM_RELEASE: s.direction = 0; break;
+            case SIM_JUMP: {
+                bool onGround = s.ground >= 0;
+                if (applyJump(s.velocityY, onGround, s.canDoubleJump, s.hasDoubleJumped)) {
+                    s.ground = -1;
+                    s.jumps++;
+                }
+                break;
+            }
+        }
+    }
+}
+
+// One fixed step, in the same order as update()
+void stepSim(SimState& s, double dt) {
+    s.time += dt;
+    s.lavaHeight += lavaRise(s.time, dt);
+    for (Platform& platform : s.platforms) {
+        if (platform.y <= s.lavaHeight) platform.active = false;
+    }
+
+    double startX = s.x, startY = s.y;
+    int landing = stepPlayerMotion(s.x, s.y, s.velocityX, s.velocityY, s.direction, s.ground >= 0, s.platforms, dt);
+    s.ground = -1;
+    if (landing >= 0) standOnSimPlatform(s, landing);
+    if (s.ground >= 0 && s.ground != s.lastPlatform) {
+        s.platformChanges++;
+        s.lastPlatform = s.ground;
+    }
+
+    if (s.y <= s.lavaHeight) {
+        s.gameOver = true;
+        return;
+    }
+
+    if (s.powerUpType > 0) {
+        s.powerUpTimer -= dt;
+        if (s.powerUpTimer <= 0) {
+            s.powerUpType = 0;
+            s.canDoubleJump = false;
+        }
+    }
+
+    s.rockSpawnTimer -= dt;
+    while (s.rockSpawnTimer <= 0) spawnSimRock(s);
+    for (size_t i = 0; i < s.rocks.size();) {
+        SimRock& rock = s.rocks[i];
+        bool hit = rockHitsPlayer(startX, startY, s.x, s.y, rock.x, rock.y, dt);
+        rock.y -= ROCK_FALL_SPEED * dt;
+        if (hit) {
+            hitSimRock(s, i);
+            if (s.gameOver) return;
+        } else if (rock.y < ROCK_GONE_Y) {
+            s.rocks.erase(s.rocks.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    for (Collectable& coin : s.collectables) {
+        if (!coin.collected && playerTouchesCoin(s.x, s.y, coin)) {
+            coin.collected = true;
+            s.coins++;
+        }
+    }
+}
+
+// c0 + c1*t + c2*t^2, t in seconds from the current event
+struct SimCurve {
+    double c0, c1, c2;
+    double at(double t) const { return c0 + (c1 + c2 * t) * t; }
+    SimCurve operator-(const SimCurve& other) const { return {c0 - other.c0, c1 - other.c1, c2 - other.c2}; }
+    SimCurve operator-(double value) const { return {c0 - value, c1, c2}; }
+};
+
+SimCurve constantCurve(double value) { return {value, 0.0, 0.0}; }
+
+// Spans of [0, limit] on which the curve is negative; returns how many (at most 2)
+int negativeSpans(const SimCurve& q, double limit, double spans[2][2]) {
+    int count = 0;
+    auto add = [&](double from, double to) {
+        from = std::max(from, 0.0);
+        to = std::min(to, limit);
+        if (to > from) {
+            spans[count][0] = from;
+            spans[count][1] = to;
+            count++;
+        }
+    };
+    if (q.c2 == 0.0) {
+        if (q.c1 == 0.0) {
+            if (q.c0 < 0.0) add(0.0, limit);
+        } else if (q.c1 > 0.0) {
+            add(0.0, -q.c0 / q.c1);
+        } else {
+            add(-q.c0 / q.c1, limit);
+        }
+        return count;
+    }
+    double discriminant = q.c1 * q.c1 - 4.0 * q.c2 * q.c0;
+    if (discriminant <= 0.0) {
+        if (q.c2 < 0.0) add(0.0, limit);
+        return count;
+    }
+    // Cancellation-free roots
+    double half = -0.5 * (q.c1 + (q.c1 >= 0.0 ? sqrt(discriminant) : -sqrt(discriminant)));
+    double first = std::min(half / q.c2, q.c0 / half);
+    double second = std::max(half / q.c2, q.c0 / half);
+    if (q.c2 > 0.0) {
+        add(first, second);
+    } else {
+        add(0.0, first);
+        add(second, limit);
+    }
+    return count;
+}
+
+// Earliest time in [0, limit] at which every curve is negative at once, or -1
+double firstTimeAllNegative(std::initializer_list<SimCurve> curves, double limit) {
+    double spans[8][2] = {{0.0, limit}};
+    int count = 1;
+    for (const SimCurve& curve : curves) {
+        double own[2][2];
+        int ownCount = negativeSpans(curve, limit, own);
+        double merged[8][2];
+        int mergedCount = 0;
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < ownCount && mergedCount < 8; j++) {
+                double from = std::max(spans[i][0], own[j][0]);
+                double to = std::min(spans[i][1], own[j][1]);
+                if (to > from) {
+                    merged[mergedCount][0] = from;
+                    merged[mergedCount][1] = to;
+                    mergedCount++;
+                }
+            }
+        }
+        if (mergedCount == 0) return -1.0;
+        memcpy(spans, merged, sizeof(merged));
+        count = mergedCount;
+    }
+    double earliest = limit;
+    for (int i = 0; i < count; i++) earliest = std::min(earliest, spans[i][0]);
+    return earliest;
+}
+
+enum SimEvent {
+    SIM_EVENT_END, SIM_EVENT_INPUT, SIM_EVENT_TOP_SPEED, SIM_EVENT_STOPPED, SIM_EVENT_REFIT, SIM_EVENT_WALL,
+    SIM_EVENT_LANDING, SIM_EVENT_WALK_OFF, SIM_EVENT_LAVA_PLATFORM, SIM_EVENT_LAVA_PLAYER,
+    SIM_EVENT_POWER_UP, SIM_EVENT_ROCK_SPAWN, SIM_EVENT_ROCK_HIT, SIM_EVENT_ROCK_GONE, SIM_EVENT_COIN
+};
+
+// Coasting x is exponential, so events are solved on its second-order expansion
+// and refit this often (error under 0.05 px at top speed on the ground)
+const double SIM_COAST_REFIT_SECONDS = 1.0 / 60.0;
+
+// Advance to the next event. Between events the held key is fixed, so player x
+// and y, the lava and every rock are polynomials of degree two or less in the
+// elapsed time, and each event is the first time a set of them turns negative
+void advanceToNextSimEvent(SimState& s, const std::vector<SimInput>& inputs, double endTime) {
+    const double maxX = WIDTH - PLAYER_WIDTH;
+
+    // Accelerating toward the held key until top speed; against a wall update()
+    // clamps x every step, so it stays put until the velocity turns around
+    double accelX = 0.0;
+    if (s.direction != 0 && s.velocityX * s.direction < PLAYER_MAX_SPEED) accelX = s.direction * PLAYER_ACCELERATION;
+    bool coasting = s.direction == 0 && s.velocityX != 0.0;
+    double decay = coasting ? -DAMPING_REFERENCE_RATE * log(s.ground >= 0 ? PLAYER_GROUND_DAMPING : PLAYER_AIR_DAMPING) : 0.0;
+    double heading = s.velocityX != 0.0 ? s.velocityX : accelX;
+    bool pinned = (s.x <= 0.0 && heading < 0.0) || (s.x >= maxX && heading > 0.0);
+    SimCurve x = pinned ? constantCurve(s.x) : SimCurve{s.x, s.velocityX, 0.5 * (accelX - decay * s.velocityX)};
+    SimCurve y = s.ground >= 0 ? constantCurve(s.y) : SimCurve{s.y, s.velocityY, -0.5 * PLAYER_GRAVITY};
+    SimCurve falling = s.ground >= 0 ? constantCurve(-1.0) : SimCurve{s.velocityY, -PLAYER_GRAVITY, 0.0};
+    SimCurve lava = {s.lavaHeight, LAVA_RISE_SCALE * (LAVA_BASE_SPEED + LAVA_SPEED_GROWTH * s.time),
+                     LAVA_RISE_SCALE * LAVA_SPEED_GROWTH / 2};
+
+    // Each candidate only has to beat the earliest event found so far
+    SimEvent event = SIM_EVENT_END;
+    int index = 0;
+    double when = endTime - s.time;
+    auto consider = [&](double t, SimEvent candidate, int candidateIndex) {
+        if (t >= 0.0 && t < when) {
+            when = t;
+            event = candidate;
+            index = candidateIndex;
+        }
+    };
+    if (s.nextInput < inputs.size()) consider(inputs[s.nextInput].time - s.time, SIM_EVENT_INPUT, 0);
+    if (accelX != 0.0) {
+        consider((s.direction * PLAYER_MAX_SPEED - s.velocityX) / accelX, SIM_EVENT_TOP_SPEED, 0);
+        if (s.velocityX * accelX < 0.0) consider(-s.velocityX / accelX, SIM_EVENT_STOPPED, 0);
+    }
+    if (coasting) {
+        consider(std::max(0.0, log(fabs(s.velocityX) / 5.0) / decay), SIM_EVENT_STOPPED, 0); // stepSim() zeroes it below 5 px/s
+        consider(SIM_COAST_REFIT_SECONDS, SIM_EVENT_REFIT, 0);
+    }
+    if (!pinned) {
+        consider(firstTimeAllNegative({x}, when), SIM_EVENT_WALL, 0);
+        consider(firstTimeAllNegative({constantCurve(maxX) - x}, when), SIM_EVENT_WALL, 1);
+    }
+    if (s.powerUpType > 0) consider(std::max(0.0, s.powerUpTimer), SIM_EVENT_POWER_UP, 0);
+    consider(std::max(0.0, s.rockSpawnTimer), SIM_EVENT_ROCK_SPAWN, 0);
+
+    // Landing: falling, feet between a platform's bottom and top, and overlapping it
+    int lowest = -1;
+    for (int i = 0; i < (int)s.platforms.size(); i++) {
+        const Platform& platform = s.platforms[i];
+        if (!platform.active) continue;
+        if (lowest < 0 || platform.y < s.platforms[lowest].y) lowest = i;
+        if (i == s.ground) continue;
+        consider(firstTimeAllNegative({falling, y - (platform.y + platform.height), constantCurve(platform.y) - y,
+                                       x - (platform.x + platform.width), constantCurve(platform.x - PLAYER_WIDTH) - x}, when),
+                 SIM_EVENT_LANDING, i);
+    }
+    if (s.ground >= 0) {
+        const Platform& platform = s.platforms[s.ground];
+        consider(firstTimeAllNegative({constantCurve(platform.x + platform.width) - x}, when), SIM_EVENT_WALK_OFF, 0);
+        consider(firstTimeAllNegative({x - (platform.x - PLAYER_WIDTH)}, when), SIM_EVENT_WALK_OFF, 0);
+    }
+    if (lowest >= 0) consider(firstTimeAllNegative({constantCurve(s.platforms[lowest].y) - lava}, when), SIM_EVENT_LAVA_PLATFORM, lowest);
+    consider(firstTimeAllNegative({y - lava}, when), SIM_EVENT_LAVA_PLAYER, 0);
+
+    for (int i = 0; i < (int)s.rocks.size(); i++) {
+        const double half = ROCK_SIZE / 2;
+        SimCurve rock = {s.rocks[i].y, -ROCK_FALL_SPEED, 0.0};
+        consider(firstTimeAllNegative({x - (s.rocks[i].x + half), constantCurve(s.rocks[i].x - half - PLAYER_WIDTH) - x,
+                                       y - rock - half, rock - half - PLAYER_HEIGHT - y}, when), SIM_EVENT_ROCK_HIT, i);
+        consider(firstTimeAllNegative({rock - ROCK_GONE_Y}, when), SIM_EVENT_ROCK_GONE, i);
+    }
+    for (int i = 0; i < (int)s.collectables.size(); i++) {
+        const Collectable& coin = s.collectables[i];
+        if (coin.collected) continue;
+        const double half = COIN_SIZE / 2;
+        consider(firstTimeAllNegative({x - (coin.x + half), constantCurve(coin.x - half - PLAYER_WIDTH) - x,
+                                       y - (coin.y + half), constantCurve(coin.y - half - PLAYER_HEIGHT) - y}, when), SIM_EVENT_COIN, i);
+    }
+
+    // Move everything to the event time
+    s.time += when;
+    s.lavaHeight = lava.at(when);
+    if (coasting) {
+        double kept = exp(-decay * when);
+        if (!pinned) s.x = std::max(0.0, std::min(maxX, s.x + s.velocityX * (1.0 - kept) / decay));
+        s.velocityX *= kept;
+    } else {
+        s.x = std::max(0.0, std::min(maxX, x.at(when)));
+        s.velocityX += accelX * when;
+    }
+    if (s.ground < 0) {
+        s.y = y.at(when);
+        s.velocityY -= PLAYER_GRAVITY * when;
+    }
+    if (s.powerUpType > 0) s.powerUpTimer -= when;
+    s.rockSpawnTimer -= when;
+    for (SimRock& rock : s.rocks) rock.y -= ROCK_FALL_SPEED * when;
+
+    switch (event) {
+        case SIM_EVENT_END:
+            s.time = endTime;
+            break;
+        case SIM_EVENT_INPUT:
+            s.time = inputs[s.nextInput].time; // Applied by the caller
+            break;
+        case SIM_EVENT_TOP_SPEED:
+            s.velocityX = s.direction * PLAYER_MAX_SPEED;
+            break;
+        case SIM_EVENT_STOPPED:
+            s.velocityX = 0.0;
+            break;
+        case SIM_EVENT_REFIT:
+            break;
+        case SIM_EVENT_WALL:
+            s.x = index ? maxX : 0.0;
+            break;
+        case SIM_EVENT_LANDING:
+            standOnSimPlatform(s, index);
+            if (index != s.lastPlatform) {
+                s.platformChanges++;
+                s.lastPlatform = index;
+            }
+            break;
+        case SIM_EVENT_WALK_OFF:
+            s.ground = -1;
+            s.velocityY = 0.0;
+            break;
+        case SIM_EVENT_LAVA_PLATFORM:
+            for (Platform& platform : s.platforms) {
+                if (platform.y <= s.platforms[index].y) platform.active = false;
+            }
+            if (s.ground >= 0 && !s.platforms[s.ground].active) {
+                s.ground = -1;
+                s.velocityY = 0.0;
+            }
+            break;
+        case SIM_EVENT_LAVA_PLAYER:
+            s.gameOver = true;
+            break;
+        case SIM_EVENT_POWER_UP:
+            s.powerUpType = 0;
+            s.canDoubleJump = false;
+            break;
+        case SIM_EVENT_ROCK_SPAWN:
+            spawnSimRock(s);
+            break;
+        case SIM_EVENT_ROCK_HIT:
+            hitSimRock(s, index);
+            break;
+        case SIM_EVENT_ROCK_GONE:
+            s.rocks.erase(s.rocks.begin() + index);
+            break;
+        case SIM_EVENT_COIN:
+            s.collectables[index].collected = true;
+            s.coins++;
+            break;
+    }
+}
+
+// Play the run to endTime with fixed steps; returns the number of steps
+int runSteppedSim(SimState& s, const std::vector<SimInput>& inputs, double endTime, double dt) {
+    int steps = 0;
+    while (!s.gameOver && s.time < endTime - 1e-9) {
+        applySimInputs(s, inputs);
+        stepSim(s, dt);
+        steps++;
+    }
+    return steps;
+}
+
+// Play the run to endTime event by event; returns the number of advances
+int fastForwardSim(SimState& s, const std::vector<SimInput>& inputs, double endTime) {
+    int advances = 0;
+    while (!s.gameOver && s.time < endTime - 1e-9) {
+        applySimInputs(s, inputs);
+        advanceToNextSimEvent(s, inputs, endTime);
+        advances++;
+    }
+    return advances;
+}
+
+// Fast-forward self-check (--check-fast-forward=N): play N scripted runs both
+// ways and require the event-driven result to match fine fixed steps within the
+// tolerance. Fixed steps still decide a grazing contact up to a step late (a
+// walk-off, say, or a rock meeting the player as the lava does), which can tip
+// a rare run; such a run is stepped again, up to FAST_FORWARD_MAX_REFINE times
+// finer, and must converge on the fast-forward result
+struct FastForwardCheck {
+    int runs = 0;
+} fastForwardCheck;
+
+const double FAST_FORWARD_STEP = 1.0 / 4000.0;        // Reference step, seconds
+const double FAST_FORWARD_RUN_SECONDS = 30.0;
+const double FAST_FORWARD_POSITION_TOLERANCE = 1.0;   // Pixels
+const double FAST_FORWARD_TIME_TOLERANCE = 0.005;     // Seconds, for when the run ends
+const int FAST_FORWARD_MAX_REFINE = 16;
+
+// A generated tower plus a random script of key presses and jumps. Inputs sit
+// on the reference step grid so both simulations apply them at the same instant
+void initSimRun(SimState& s, std::vector<SimInput>& inputs, uint32_t seed) {
+    Level level;
+    generateLevel(level, seed);
+    s = SimState();
+    s.platforms = level.platforms;
+    s.collectables = level.collectables;
+    s.random = LevelRandom(seed ^ 0x51A7E5u);
+    s.powerUpType = s.random.below(3); // Start some runs shielded or with double jump
+    s.powerUpTimer = s.powerUpType > 0 ? 12.0 : 0.0;
+    s.canDoubleJump = s.powerUpType == 2;
+
+    LevelRandom script(seed);
+    inputs.clear();
+    int step = 0;
+    while (true) {
+        step += 400 + script.below(4000); // 0.1s - 1.1s apart
+        if (step * FAST_FORWARD_STEP >= FAST_FORWARD_RUN_SECONDS) break;
+        inputs.push_back({step * FAST_FORWARD_STEP, (SimAction)script.below(4)});
+    }
+}
+
+int runFastForwardCheck() {
+    int diverged = 0, outOfTolerance = 0, refined = 0;
+    long long steps = 0, advances = 0;
+    double steppedMs = 0.0, fastMs = 0.0, worstPosition = 0.0, worstTime = 0.0;
+    
+    // Runs are independent: play them as tasks, then compare them in order
+    struct RunResult {
+        SimState stepped, fast;
+        long long steps = 0, advances = 0;
+        double steppedMs = 0.0, fastMs = 0.0;
+    };
+    std::vector<RunResult> results(fastForwardCheck.runs);
+    tasks.parallelFor(0, fastForwardCheck.runs, 8, [&](int first, int last) {
+        for (int run = first; run < last; run++) {
+            RunResult& result = results[run];
+            std::vector<SimInput> inputs;
+            initSimRun(result.stepped, inputs, run);
+            result.fast = result.stepped;
+            double start = nowMs();
+            result.steps = runSteppedSim(result.stepped, inputs, FAST_FORWARD_RUN_SECONDS, FAST_FORWARD_STEP);
+            double middle = nowMs();
+            result.advances = fastForwardSim(result.fast, inputs, FAST_FORWARD_RUN_SECONDS);
+            result.fastMs = nowMs() - middle;
+            result.steppedMs = middle - start;
+        }
+    });
+    
+    auto sameOutcome = [](const SimState& a, const SimState& b) {
+        return a.gameOver == b.gameOver && a.lives == b.lives && a.jumps == b.jumps && a.platformChanges == b.platformChanges &&
+               a.coins == b.coins && a.rockHits == b.rockHits && a.rocksSpawned == b.rocksSpawned;
+    };
+    auto positionError = [](const SimState& a, const SimState& b) { return std::max(fabs(a.x - b.x), fabs(a.y - b.y)); };
+    auto withinTolerance = [&](const SimState& a, const SimState& b) {
+        return sameOutcome(a, b) && positionError(a, b) <= FAST_FORWARD_POSITION_TOLERANCE &&
+               fabs(a.time - b.time) <= FAST_FORWARD_TIME_TOLERANCE;
+    };
+
+    for (int run = 0; run < fastForwardCheck.runs; run++) {
+        SimState& stepped = results[run].stepped;
+        const SimState& fast = results[run].fast;
+        steps += results[run].steps;
+        advances += results[run].advances;
+        steppedMs += results[run].steppedMs;
+        fastMs += results[run].fastMs;
+
+        if (!withinTolerance(stepped, fast)) {
+            for (int refine = 2; refine <= FAST_FORWARD_MAX_REFINE && !withinTolerance(stepped, fast); refine *= 2) {
+                std::vector<SimInput> inputs;
+                initSimRun(stepped, inputs, run);
+                runSteppedSim(stepped, inputs, FAST_FORWARD_RUN_SECONDS, FAST_FORWARD_STEP / refine);
+            }
+            if (withinTolerance(stepped, fast)) refined++;
+        }
+        if (!sameOutcome(stepped, fast)) {
+            diverged++;
+        } else {
+            worstPosition = std::max(worstPosition, positionError(stepped, fast));
+            worstTime = std::max(worstTime, fabs(stepped.time - fast.time));
+            if (withinTolerance(stepped, fast)) continue;
+            outOfTolerance++;
+        }
+        if (diverged + outOfTolerance <= 5) {
+            printf("  run %d %s: stepped t=%.4f (%.2f, %.2f) jumps %d platforms %d coins %d hits %d lives %d%s\n"
+                   "                       fast-forward t=%.4f (%.2f, %.2f) jumps %d platforms %d coins %d hits %d lives %d%s\n",
+                   run, sameOutcome(stepped, fast) ? "out of tolerance" : "diverged", stepped.time, stepped.x, stepped.y,
+                   stepped.jumps, stepped.platformChanges, stepped.coins, stepped.rockHits, stepped.lives,
+                   stepped.gameOver ? " game over" : "", fast.time, fast.x, fast.y, fast.jumps, fast.platformChanges,
+                   fast.coins, fast.rockHits, fast.lives, fast.gameOver ? " game over" : "");
+        }
+    }
+
+    int runs = std::max(1, fastForwardCheck.runs);
+    printf("Fast-forward check: %d runs of up to %.0f s\n", fastForwardCheck.runs, FAST_FORWARD_RUN_SECONDS);
+    printf("  diverged:         %d\n", diverged);
+    printf("  out of tolerance: %d (%.2f px, %.3f s)\n", outOfTolerance, FAST_FORWARD_POSITION_TOLERANCE, FAST_FORWARD_TIME_TOLERANCE);
+    printf("  refined:          %d (matched at a finer step, at most 1/%.0f s)\n", refined,
+           FAST_FORWARD_MAX_REFINE / FAST_FORWARD_STEP);
+    printf("  stepped:      %.0f steps per run, %.2f ms per run\n", (double)steps / runs, steppedMs / runs);
+    printf("  fast-forward: %.0f advances per run, %.2f ms per run (%.0fx faster)\n", (double)advances / runs,
+           fastMs / runs, steppedMs / std::max(fastMs, 0.001));
+    printf("  worst difference: %.4f px, %.5f s\n", worstPosition, worstTime);
+    return outOfTolerance == 0 && diverged == 0 ? 0 : 1;
+}
+
+// Tick-rate self-check (--check-tick-rates=N): play N scripted runs on a flat
+// floor at update rates down to the 10 Hz of a hitch and compare each
+// trajectory with a fine-step reference. The floor keeps a slightly lower
+// 30 Hz jump arc from changing which platform is landed on
+struct TickRateCheck {
+    int runs = 0;
+} tickRateCheck;
+
+const int TICK_CHECK_RATES[] = {10, 30, 60, 144}; // 10 Hz: every frame a timer() hitch
+// Trajectory samples per second at each rate, also the grid the script's inputs
+// sit on; must divide the rate. 10 Hz can't step through the finer grid
+const int TICK_SAMPLE_RATES[] = {2, 6, 6, 6};
+const int TICK_REFERENCE_RATE = 2880; // Multiple of every checked rate
+const double TICK_RUN_SECONDS = 20.0;
+// Allowed difference: each tick's motion is exact, landings and turning away
+// from a wall included, and the floor has no edge to walk off, so every rate
+// should agree up to rounding
+const double TICK_TOLERANCE = 0.01; // Pixels
+
+// The run's starting state and a script of inputs on a grid of sampleRate
+// steps per second, which every rate it divides steps through exactly. Jumps
+// are spaced out so every rate has landed again before the next one; the extra
+// press comes mid-air and only counts with the power-up
+void initTickRun(SimState& initial, std::vector<SimInput>& inputs, int run, int sampleRate) {
+    initial = SimState();
+    initial.platforms = {{0.0f, 40.0f, (float)WIDTH, 20.0f, true}};
+    initial.lavaHeight = -1e9;
+    initial.rockSpawnTimer = 1e9;
+    LevelRandom script(run);
+    if (script.below(2)) {
+        initial.powerUpType = 2;
+        initial.powerUpTimer = 1e9;
+        initial.canDoubleJump = true;
+    }
+    inputs.clear();
+    for (int sample = 1 + script.below(sampleRate); sample < TICK_RUN_SECONDS * sampleRate; sample += 1 + script.below(sampleRate)) {
+        inputs.push_back({(double)sample / sampleRate, (SimAction)script.below(3)});
+    }
+    for (int sample = sampleRate + script.below(sampleRate); sample < TICK_RUN_SECONDS * sampleRate;
+         sample += 2 * sampleRate + script.below(sampleRate)) {
+        inputs.push_back({(double)sample / sampleRate, SIM_JUMP});
+        inputs.push_back({(double)(sample + std::max(1, sampleRate / 3)) / sampleRate, SIM_JUMP});
+    }
+    std::stable_sort(inputs.begin(), inputs.end(), [](const SimInput& a, const SimInput& b) { return a.time < b.time; });
+}
+
+// Positions sampled sampleRate times a second while stepping at `rate`
+void sampleTrajectory(const SimState& initial, const std::vector<SimInput>& inputs, int rate, int sampleRate,
+                      std::vector<double>& samples) {
+    SimState s = initial;
+    samples.clear();
+    int stepsPerSample = rate / sampleRate;
+    for (int step = 0; step < TICK_RUN_SECONDS * rate; step++) {
+        if (step % stepsPerSample == 0) {
+            samples.push_back(s.x);
+            samples.push_back(s.y);
+        }
+        applySimInputs(s, inputs);
+        stepSim(s, 1.0 / rate);
+    }
+}
+
+int runTickRateCheck() {
+    const int rateCount = sizeof(TICK_CHECK_RATES) / sizeof(TICK_CHECK_RATES[0]);
+    double worst[rateCount] = {};
+    int failures[rateCount] = {};
+    std::vector<std::array<double, rateCount>> errors(tickRateCheck.runs); // Per run and rate
+    tasks.parallelFor(0, tickRateCheck.runs, 4, [&](int first, int last) {
+        SimState initial;
+        std::vector<SimInput> inputs;
+        std::vector<double> reference, samples;
+        for (int run = first; run < last; run++) {
+            int gridRate = 0;
+            for (int r = 0; r < rateCount; r++) {
+                if (TICK_SAMPLE_RATES[r] != gridRate) {
+                    gridRate = TICK_SAMPLE_RATES[r];
+                    initTickRun(initial, inputs, run, gridRate);
+                    sampleTrajectory(initial, inputs, TICK_REFERENCE_RATE, gridRate, reference);
+                }
+                sampleTrajectory(initial, inputs, TICK_CHECK_RATES[r], gridRate, samples);
+                double error = 0.0;
+                for (size_t i = 0; i < samples.size(); i++) error = std::max(error, fabs(samples[i] - reference[i]));
+                errors[run][r] = error;
+            }
+        }
+    });
+    for (int run = 0; run < tickRateCheck.runs; run++) {
+        for (int r = 0; r < rateCount; r++) {
+            worst[r] = std::max(worst[r], errors[run][r]);
+            failures[r] += errors[run][r] > TICK_TOLERANCE;
+        }
+    }
+
+    printf("Tick-rate check: %d runs of %.0f s against %d Hz steps (tolerance %.2f px)\n", tickRateCheck.runs, TICK_RUN_SECONDS,
+           TICK_REFERENCE_RATE, TICK_TOLERANCE);
+    int failed = 0;
+    for (int r = 0; r < rateCount; r++) {
+        printf("  %3d Hz: worst difference %.4f px, %d runs over\n", TICK_CHECK_RATES[r], worst[r], failures[r]);
+        failed += failures[r];
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// Initialize game
+void initGame() {
+    // Don't reseed srand - keep randomization between games
+    static bool seeded = false;
+    if (!seeded) {
+        srand(time(NULL));
+        seeded = true;
     }
     
-    // Add final platform near the door at the top
-    float doorPlatformY = HEIGHT - 200; // Platform just below door
-    float doorPlatformX = WIDTH / 2 - 60; // Centered under door
-    platforms.push_back({doorPlatformX, doorPlatformY, 120, 15, true});
+    // Reset movement keys
+    leftPressed = false;
+    rightPressed = false;
     
-    // Create collectables (at least 5) - Place them near platforms
-    collectables.clear();
-    for (int i = 0; i < 10; i++) { // More collectables for bigger game
-        if (i < platforms.size() - 2) { // Avoid last platform (door platform)
-            // Place collectables near platforms for easier collection
-            float platX = platforms[i + 1].x + platforms[i + 1].width / 2;
-            float platY = platforms[i + 1].y + platforms[i + 1].height + 20;
-            float x = platX + (rand() % 60 - 30); // Small offset from platform center
-            float y = platY + (rand() % 30);
-            collectables.push_back({x, y, false, 0.0f, i});
-        } else {
-            // Backup placement for extra collectables in middle area
-            float x = 100 + rand() % (WIDTH - 200);
-            float y = 250 + i * 60 + rand() % 30;
-            collectables.push_back({x, y, false, 0.0f, i});
-        }
+    // Initialize player with better stats
+    player.x = WIDTH / 2.0f;
+    player.y = 110.0f; // Start slightly higher
+    player.velocityX = 0.0f;
+    player.velocityY = 0.0f;
+    player.width = PLAYER_WIDTH;
+    player.height = PLAYER_HEIGHT;
+    player.onGround = false;
+    player.hasKey = false;
+    player.powerUpType = 0;
+    player.powerUpTimer = 0.0f;
+    player.canDoubleJump = false;
+    player.hasDoubleJumped = false;
+    
+    // Swap in the banked tower, or a pre-generated random one
+    Level level;
+    if (bankedLevel.enabled) {
+        level = bankedLevel.level;
+    } else {
+        levelPool.take(level);
     }
+    platforms = std::move(level.platforms);
+    collectables = std::move(level.collectables);
+    mainPathPlatformCount = level.mainPathPlatformCount;
+    powerUpZoneLeft = level.powerUpZoneLeft;
+    powerUpZoneRight = level.powerUpZoneRight;
     
     rocks.clear();
     powerUps.clear();
     
     // Reset door animation states
+    sequences.clear();
     doorAnimTime = 0.0f;
     doorUnlockAnimTime = 0.0f;
     doorEnterAnimTime = 0.0f;
@@ -290,7 +3174,17 @@ void initGame() {
     
     // Reset suction animation
     playerBeingSucked = false;
-    suctionAnimTime = 0.0f;
+    
+    // Drop effects from the previous run
+    clearParticles(effectParticles);
+    GameEffectEvent staleEffect;
+    while (gameEffects.pop(staleEffect)) {}
+    inputGame.fetch_add(1, std::memory_order_release); // Keys pressed as the last game ended
+    pendingInput = AppliedInput();
+    emberEmitDebt = 0.0f;
+    suctionEmitDebt = 0.0f;
+    
+    publishRenderSnapshot(0.0);
 }
 
 // Check collision between two rectangles
@@ -302,6 +3196,10 @@ bool checkCollision(float x1, float y1, float w1, float h1,
 
 // Draw text
 void drawText(float x, float y, const char* text) {
+    if (renderBackend == RENDER_CORE) {
+        coreDrawText(x, y, text);
+        return;
+    }
     glRasterPos2f(x, y);
     while (*text) {
         glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *text);
@@ -311,9 +3209,9 @@ void drawText(float x, float y, const char* text) {
 
 // Draw shadowed text with custom color
 void drawShadowedText(float x, float y, const char* text, float r, float g, float b) {
-    glColor3f(0.0f, 0.0f, 0.0f);
+    gfxColor3f(0.0f, 0.0f, 0.0f);
     drawText(x + 1, y - 1, text);
-    glColor3f(r, g, b);
+    gfxColor3f(r, g, b);
     drawText(x, y, text);
 }
 
@@ -325,33 +3223,254 @@ void drawShadowedTextCentered(float cx, float y, const char* text, float r, floa
 void drawLayeredBackground();
 void initFallingCharacters();
 
-// Load texture from image file
-GLuint loadTexture(const char* filename, int* width, int* height) {
-    int channels;
-    unsigned char* data = stbi_load(filename, width, height, &channels, 4);
-    if (!data) {
-        std::cerr << "Failed to load texture: " << filename << std::endl;
-        return 0;
-    }
-    
+// Create a texture from decoded RGBA pixels
+GLuint uploadTexture(const unsigned char* data, int width, int height) {
     GLuint textureID;
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_2D, textureID);
     
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, *width, *height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     
-    stbi_image_free(data);
     return textureID;
 }
 
+// Asset loading: assets come from assets.pak next to the executable (built by
+// pack_assets, images already decoded), falling back to loose files. Worker threads
+// page them in at startup so the first frame doesn't wait on asset size; the GL
+// thread uploads each image as it completes (finishAsset, a sequence suspended on
+// the load) and the menu shows the pixel-art logo until then.
+enum AssetState { ASSET_QUEUED, ASSET_READY, ASSET_FAILED };
+
+struct AssetJob {
+    const char* filename;
+    GLuint* texture;                 // Image target (nullptr for sounds)
+    int* width;
+    int* height;
+    std::atomic<int> state{ASSET_QUEUED}; // Published by the worker
+    const unsigned char* pixels = nullptr; // RGBA texels: a view into the pack, or decoded
+    bool ownsPixels = false;         // Decoded by stb_image, freed after upload
+    int decodedWidth = 0, decodedHeight = 0;
+    std::string playPath{};          // Sounds: file handed to the player
+    Sequence finisher{};             // GL-thread half of the load (finishAsset)
+    std::coroutine_handle<> waiter{}; // finisher, suspended until the worker publishes
+};
+
+AssetJob assetJobs[] = {
+    {"IcyTowerLogo.png", &logoTexture, &logoWidth, &logoHeight},
+    {"game-start-6104.mp3", nullptr, nullptr, nullptr},
+    {"game-bonus-02-294436.mp3", nullptr, nullptr, nullptr},
+    {"game-over-417465.mp3", nullptr, nullptr, nullptr},
+    {"you-win-sequence-1-183948.mp3", nullptr, nullptr, nullptr},
+};
+const int ASSET_COUNT = sizeof(assetJobs) / sizeof(assetJobs[0]);
+int assetsPending = ASSET_COUNT; // Jobs the GL thread hasn't handled yet
+AssetPack assetPack;
+std::string assetDirectory; // Directory of the executable, with a trailing slash
+
+#ifdef ICYTOWER_EMBED_ASSETS
+// Archive compiled into the executable (generated by pack_assets --source)
+extern const unsigned char embeddedAssetPack[];
+extern const size_t embeddedAssetPackSize;
+#endif
+
+// Directory holding the running executable, so assets don't depend on the cwd
+std::string executableDirectory(const char* argv0) {
+    std::string path;
+#ifdef __APPLE__
+    char buffer[4096];
+    uint32_t size = sizeof(buffer);
+    if (_NSGetExecutablePath(buffer, &size) == 0) path = buffer;
+#else
+    char buffer[4096];
+    ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+    if (length > 0) path.assign(buffer, length);
+#endif
+    if (path.empty() && argv0) path = argv0;
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// Loose asset file: next to the executable first, then the working directory
+std::string findAssetFile(const char* filename) {
+    std::string besideExecutable = assetDirectory + filename;
+    if (!assetDirectory.empty() && access(besideExecutable.c_str(), R_OK) == 0) return besideExecutable;
+    return filename;
+}
+
+// afplay needs a file, so packed sounds are written out to a directory only this
+// process uses: mkdtemp creates it with mode 0700 under a fresh name, and files
+// are created exclusively, so nothing planted in the temp directory is followed,
+// reused or shared with another instance. Removed again at exit
+std::string soundSpoolDirectory;
+
+// At exit. Loading tasks may still be writing sounds, so it waits (briefly) for
+// every job to publish its state, then empties the directory by listing it
+// rather than reading the jobs' paths
+void removeSoundSpool() {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    for (const AssetJob& job : assetJobs) {
+        while (job.state.load(std::memory_order_acquire) == ASSET_QUEUED && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (DIR* directory = opendir(soundSpoolDirectory.c_str())) {
+        while (dirent* file = readdir(directory)) {
+            if (strcmp(file->d_name, ".") != 0 && strcmp(file->d_name, "..") != 0) unlinkat(dirfd(directory), file->d_name, 0);
+        }
+        closedir(directory);
+    }
+    rmdir(soundSpoolDirectory.c_str());
+}
+
+// Called before the loading tasks start, so they only read soundSpoolDirectory
+void createSoundSpool() {
+    const char* tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp && *tmp ? tmp : "/tmp") + "/icytower-XXXXXX";
+    if (!mkdtemp(&pattern[0])) {
+        std::cerr << "Warning: can't create a directory for packed sounds" << std::endl;
+        return;
+    }
+    soundSpoolDirectory = pattern;
+    std::atexit(removeSoundSpool);
+}
+
+bool spoolPackedSound(const PackEntry& entry, std::string& path) {
+    if (soundSpoolDirectory.empty() || strchr(entry.name, '/')) return false;
+    path = soundSpoolDirectory + "/" + entry.name;
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0600);
+    if (fd < 0) return false;
+    FILE* file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        return false;
+    }
+    bool ok = fwrite(assetPack.data(entry), 1, entry.size, file) == entry.size;
+    return fclose(file) == 0 && ok;
+}
+
+void loadAsset(AssetJob& job) {
+    const PackEntry* entry = assetPack.isOpen() ? assetPack.find(job.filename) : nullptr;
+    bool ok;
+    if (job.texture && entry && entry->kind == PACK_RGBA8) {
+        assetPack.prefetch(*entry);
+        job.pixels = assetPack.data(*entry);
+        job.decodedWidth = entry->width;
+        job.decodedHeight = entry->height;
+        ok = true;
+    } else if (job.texture) {
+        int channels;
+        job.pixels = stbi_load(findAssetFile(job.filename).c_str(), &job.decodedWidth, &job.decodedHeight, &channels, 4);
+        job.ownsPixels = true;
+        ok = job.pixels != nullptr;
+    } else if (entry && entry->kind == PACK_SOUND) {
+        ok = spoolPackedSound(*entry, job.playPath);
+    } else {
+        // Loose sound: reading it checks it exists and warms the file cache
+        // so the first playback starts promptly
+        job.playPath = findAssetFile(job.filename);
+        FILE* file = fopen(job.playPath.c_str(), "rb");
+        ok = file != nullptr;
+        if (file) {
+            char buffer[64 * 1024];
+            while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+            fclose(file);
+        }
+    }
+    job.state.store(ok ? ASSET_READY : ASSET_FAILED, std::memory_order_release);
+}
+
+// Awaitable: resume once the job's loading task has published, yielding its state.
+// pollAssets resumes the waiter on the GL thread
+struct AssetLoaded {
+    AssetJob& job;
+    bool await_ready() const { return job.state.load(std::memory_order_acquire) != ASSET_QUEUED; }
+    void await_suspend(std::coroutine_handle<> sequence) { job.waiter = sequence; }
+    int await_resume() const { return job.state.load(std::memory_order_acquire); }
+};
+
+// Upload or report a job once its load completes (GL thread)
+Sequence finishAsset(AssetJob& job) {
+    int state = co_await AssetLoaded{job};
+    if (state == ASSET_FAILED) {
+        std::cerr << "Warning: Failed to load " << job.filename << std::endl;
+    } else if (job.texture) {
+        *job.texture = uploadTexture(job.pixels, job.decodedWidth, job.decodedHeight);
+        *job.width = job.decodedWidth;
+        *job.height = job.decodedHeight;
+        if (job.ownsPixels) stbi_image_free((void*)job.pixels);
+        job.pixels = nullptr;
+    }
+    assetsPending--;
+}
+
+// Open the asset pack and queue a loading task per asset (they only touch their
+// job and the pack; the GL thread picks up the results in pollAssets)
+void startAssetLoading(const char* argv0) {
+    assetDirectory = executableDirectory(argv0);
+#ifdef ICYTOWER_EMBED_ASSETS
+    if (!assetPack.openMemory(embeddedAssetPack, embeddedAssetPackSize)) {
+        std::cerr << "Warning: embedded assets are corrupt, loading loose asset files" << std::endl;
+    }
+#else
+    if (!assetPack.open(assetDirectory + "assets.pak") && !assetPack.open("assets.pak")) {
+        std::cerr << "Note: assets.pak not found or invalid, loading loose asset files" << std::endl;
+    }
+#endif
+    if (assetPack.isOpen()) createSoundSpool();
+    
+    for (AssetJob& job : assetJobs) {
+        job.finisher = finishAsset(job); // Suspends: nothing is loaded yet
+        tasks.spawn([&job] { loadAsset(job); });
+    }
+}
+
+// Open the bank and pick the requested level; falls back to random towers
+void loadBankedLevel() {
+    if (!bankedLevel.enabled) return;
+    bool opened = !bankedLevel.bankPath.empty() ? seedBank.open(bankedLevel.bankPath)
+                : (seedBank.open(assetDirectory + "levels.bank") || seedBank.open("levels.bank"));
+    const SeedBankEntry* entry = !opened ? nullptr
+                               : bankedLevel.byRank ? seedBank.findPercentile(bankedLevel.difficulty)
+                               : seedBank.findDifficulty(bankedLevel.difficulty);
+    if (!seedBank.load(entry, bankedLevel.level)) {
+        std::cerr << "Warning: no usable seed bank, playing random towers" << std::endl;
+        bankedLevel.enabled = false;
+        return;
+    }
+    std::cerr << "Banked level: seed " << entry->seed << ", difficulty " << entry->difficulty
+              << ", " << entry->pathJumps << " jumps" << std::endl;
+}
+
+// Resume the finishers whose loads completed (GL thread, start of each frame)
+void pollAssets() {
+    if (assetsPending == 0) return;
+    for (AssetJob& job : assetJobs) {
+        if (job.waiter && job.state.load(std::memory_order_acquire) != ASSET_QUEUED) {
+            std::exchange(job.waiter, nullptr).resume();
+            job.finisher.reset(); // Finished: return its frame to the pool
+        }
+    }
+}
+
 // Play sound using macOS afplay command
 void playSound(const char* filename) {
-    std::string command = std::string("afplay ") + filename + " &";
+    // Play the loader's copy; skip sounds it found missing instead of spawning a failing player
+    std::string path = filename;
+    for (const AssetJob& job : assetJobs) {
+        if (strcmp(job.filename, filename) != 0) continue;
+        int state = job.state.load(std::memory_order_acquire);
+        if (state == ASSET_FAILED) return;
+        path = state == ASSET_READY ? job.playPath : findAssetFile(filename);
+    }
+    // Single-quoted for the shell, with any quote in the path escaped
+    std::string quoted;
+    for (char c : path) quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    std::string command = "afplay '" + quoted + "' &";
     system(command.c_str());
 }
 
@@ -366,24 +3485,22 @@ void drawIcyTowerLogo(float centerX, float centerY) {
     float x = centerX - displayWidth / 2.0f;
     float y = centerY - displayHeight / 2.0f;
     
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, logoTexture);
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    gfxEnableTexture(logoTexture);
+    gfxColor4f(1.0f, 1.0f, 1.0f, 1.0f);
     
-    glBegin(GL_QUADS);
-    glTexCoord2f(0.0f, 1.0f); glVertex2f(x, y);
-    glTexCoord2f(1.0f, 1.0f); glVertex2f(x + displayWidth, y);
-    glTexCoord2f(1.0f, 0.0f); glVertex2f(x + displayWidth, y + displayHeight);
-    glTexCoord2f(0.0f, 0.0f); glVertex2f(x, y + displayHeight);
-    glEnd();
+    gfxBegin(GL_QUADS);
+    gfxTexCoord2f(0.0f, 1.0f); gfxVertex2f(x, y);
+    gfxTexCoord2f(1.0f, 1.0f); gfxVertex2f(x + displayWidth, y);
+    gfxTexCoord2f(1.0f, 0.0f); gfxVertex2f(x + displayWidth, y + displayHeight);
+    gfxTexCoord2f(0.0f, 0.0f); gfxVertex2f(x, y + displayHeight);
+    gfxEnd();
     
-    glDisable(GL_TEXTURE_2D);
+    gfxDisableTexture();
 }
 
-// Old pixel art version (keeping as backup)
+// Pixel art version (shown while the PNG logo is loading or if it's missing)
 void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
     float pixelSize = 8.0f; // Bigger pixels
-    logoGlowTime += 0.016f; // Increment glow timer
     
     // Create glow wave that moves from left to right every 3 seconds
     float glowWave = fmod(logoGlowTime, 3.0f) / 3.0f; // 0 to 1 over 3 seconds
@@ -432,23 +3549,23 @@ void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
         }
         
         // Ice blue colors with glow
-        glColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
-        glBegin(GL_QUADS);
-        glVertex2f(pixelX, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY + pixelSize);
-        glVertex2f(pixelX, pixelY + pixelSize);
-        glEnd();
+        gfxColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(pixelX, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY + pixelSize);
+        gfxVertex2f(pixelX, pixelY + pixelSize);
+        gfxEnd();
         
         // Ice crystal effect on some pixels
         if (i % 3 == 0) {
-            glColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
-            glBegin(GL_LINES);
-            glVertex2f(pixelX + 1, pixelY + 1);
-            glVertex2f(pixelX + pixelSize - 1, pixelY + pixelSize - 1);
-            glVertex2f(pixelX + pixelSize - 1, pixelY + 1);
-            glVertex2f(pixelX + 1, pixelY + pixelSize - 1);
-            glEnd();
+            gfxColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
+            gfxBegin(GL_LINES);
+            gfxVertex2f(pixelX + 1, pixelY + 1);
+            gfxVertex2f(pixelX + pixelSize - 1, pixelY + pixelSize - 1);
+            gfxVertex2f(pixelX + pixelSize - 1, pixelY + 1);
+            gfxVertex2f(pixelX + 1, pixelY + pixelSize - 1);
+            gfxEnd();
         }
     }
     
@@ -463,20 +3580,20 @@ void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
             glowIntensity = 1.5f + 0.5f * sin((glowWave - normalizedX) * 50.0f);
         }
         
-        glColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
-        glBegin(GL_QUADS);
-        glVertex2f(pixelX, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY + pixelSize);
-        glVertex2f(pixelX, pixelY + pixelSize);
-        glEnd();
+        gfxColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(pixelX, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY + pixelSize);
+        gfxVertex2f(pixelX, pixelY + pixelSize);
+        gfxEnd();
         
         if (i % 2 == 0) {
-            glColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
-            glBegin(GL_LINES);
-            glVertex2f(pixelX + 1, pixelY + 1);
-            glVertex2f(pixelX + pixelSize - 1, pixelY + pixelSize - 1);
-            glEnd();
+            gfxColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
+            gfxBegin(GL_LINES);
+            gfxVertex2f(pixelX + 1, pixelY + 1);
+            gfxVertex2f(pixelX + pixelSize - 1, pixelY + pixelSize - 1);
+            gfxEnd();
         }
     }
     
@@ -491,20 +3608,20 @@ void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
             glowIntensity = 1.5f + 0.5f * sin((glowWave - normalizedX) * 50.0f);
         }
         
-        glColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
-        glBegin(GL_QUADS);
-        glVertex2f(pixelX, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY);
-        glVertex2f(pixelX + pixelSize, pixelY + pixelSize);
-        glVertex2f(pixelX, pixelY + pixelSize);
-        glEnd();
+        gfxColor3f(0.4f * glowIntensity, 0.8f * glowIntensity, 1.0f * glowIntensity);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(pixelX, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY);
+        gfxVertex2f(pixelX + pixelSize, pixelY + pixelSize);
+        gfxVertex2f(pixelX, pixelY + pixelSize);
+        gfxEnd();
         
         if (i % 3 == 1) {
-            glColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
-            glBegin(GL_LINES);
-            glVertex2f(pixelX + 1, pixelY + 1);
-            glVertex2f(pixelX + pixelSize - 1, pixelY + 1);
-            glEnd();
+            gfxColor3f(0.8f * glowIntensity, 0.9f * glowIntensity, 1.0f * glowIntensity);
+            gfxBegin(GL_LINES);
+            gfxVertex2f(pixelX + 1, pixelY + 1);
+            gfxVertex2f(pixelX + pixelSize - 1, pixelY + 1);
+            gfxEnd();
         }
     }
     
@@ -570,29 +3687,29 @@ void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
     // Draw TOWER with brick colors
     auto drawBrickPixel = [&](float px, float py) {
         // Main brick color
-        glColor3f(0.6f, 0.3f, 0.2f);
-        glBegin(GL_QUADS);
-        glVertex2f(px, py);
-        glVertex2f(px + pixelSize, py);
-        glVertex2f(px + pixelSize, py + pixelSize);
-        glVertex2f(px, py + pixelSize);
-        glEnd();
+        gfxColor3f(0.6f, 0.3f, 0.2f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(px, py);
+        gfxVertex2f(px + pixelSize, py);
+        gfxVertex2f(px + pixelSize, py + pixelSize);
+        gfxVertex2f(px, py + pixelSize);
+        gfxEnd();
         
         // Mortar lines
-        glColor3f(0.4f, 0.2f, 0.1f);
-        glBegin(GL_LINES);
-        glVertex2f(px, py); glVertex2f(px + pixelSize, py);
-        glVertex2f(px, py); glVertex2f(px, py + pixelSize);
-        glEnd();
+        gfxColor3f(0.4f, 0.2f, 0.1f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(px, py); gfxVertex2f(px + pixelSize, py);
+        gfxVertex2f(px, py); gfxVertex2f(px, py + pixelSize);
+        gfxEnd();
         
         // Highlight
-        glColor3f(0.8f, 0.5f, 0.3f);
-        glBegin(GL_LINES);
-        glVertex2f(px + 1, py + 1);
-        glVertex2f(px + pixelSize - 1, py + 1);
-        glVertex2f(px + 1, py + 1);
-        glVertex2f(px + 1, py + pixelSize - 1);
-        glEnd();
+        gfxColor3f(0.8f, 0.5f, 0.3f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(px + 1, py + 1);
+        gfxVertex2f(px + pixelSize - 1, py + 1);
+        gfxVertex2f(px + 1, py + 1);
+        gfxVertex2f(px + 1, py + pixelSize - 1);
+        gfxEnd();
     };
     
     // Draw each letter with updated counts
@@ -616,13 +3733,13 @@ void drawIcyTowerLogoPixelArt(float centerX, float centerY) {
 // Brick-style UI panel with optional soft shadow
 void drawBrickPanelWithShadow(float x, float y, float width, float height, float r, float g, float b, float shadowAlpha = 0.25f) {
     // Soft shadow
-    glColor4f(0.0f, 0.0f, 0.0f, shadowAlpha);
-    glBegin(GL_QUADS);
-    glVertex2f(x + 2, y - 2);
-    glVertex2f(x + width + 2, y - 2);
-    glVertex2f(x + width + 2, y + height - 2);
-    glVertex2f(x + 2, y + height - 2);
-    glEnd();
+    gfxColor4f(0.0f, 0.0f, 0.0f, shadowAlpha);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(x + 2, y - 2);
+    gfxVertex2f(x + width + 2, y - 2);
+    gfxVertex2f(x + width + 2, y + height - 2);
+    gfxVertex2f(x + 2, y + height - 2);
+    gfxEnd();
     
     // Panel itself
     drawBrickPanel(x, y, width, height, r, g, b);
@@ -631,13 +3748,13 @@ void drawBrickPanelWithShadow(float x, float y, float width, float height, float
 // Draw brick-style UI panel
 void drawBrickPanel(float x, float y, float width, float height, float r, float g, float b) {
     // Background
-    glColor3f(r * 0.7f, g * 0.7f, b * 0.7f);
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + width, y);
-    glVertex2f(x + width, y + height);
-    glVertex2f(x, y + height);
-    glEnd();
+    gfxColor3f(r * 0.7f, g * 0.7f, b * 0.7f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(x, y);
+    gfxVertex2f(x + width, y);
+    gfxVertex2f(x + width, y + height);
+    gfxVertex2f(x, y + height);
+    gfxEnd();
     
     // Brick pattern on UI
     int smallBrickW = 15;
@@ -652,695 +3769,775 @@ void drawBrickPanel(float x, float y, float width, float height, float r, float
             float actualWidth = std::min((float)smallBrickW, x + width - brickX);
             
             // Slightly lighter brick color for UI
-            glColor3f(r * 0.9f, g * 0.9f, b * 0.9f);
-            glBegin(GL_QUADS);
-            glVertex2f(brickX, by);
-            glVertex2f(brickX + actualWidth - 1, by);
-            glVertex2f(brickX + actualWidth - 1, by + smallBrickH - 1);
-            glVertex2f(brickX, by + smallBrickH - 1);
-            glEnd();
+            gfxColor3f(r * 0.9f, g * 0.9f, b * 0.9f);
+            gfxBegin(GL_QUADS);
+            gfxVertex2f(brickX, by);
+            gfxVertex2f(brickX + actualWidth - 1, by);
+            gfxVertex2f(brickX + actualWidth - 1, by + smallBrickH - 1);
+            gfxVertex2f(brickX, by + smallBrickH - 1);
+            gfxEnd();
         }
     }
     
     // Border
-    glColor3f(r * 1.2f, g * 1.2f, b * 1.2f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(x, y);
-    glVertex2f(x + width, y);
-    glVertex2f(x + width, y + height);
-    glVertex2f(x, y + height);
-    glEnd();
+    gfxColor3f(r * 1.2f, g * 1.2f, b * 1.2f);
+    gfxBegin(GL_LINE_LOOP);
+    gfxVertex2f(x, y);
+    gfxVertex2f(x + width, y);
+    gfxVertex2f(x + width, y + height);
+    gfxVertex2f(x, y + height);
+    gfxEnd();
 }
 
 // Draw witch character (4+ primitives: dress, hat, hands, broomstick)
 void drawWitch(float x, float y, bool inMenu = false) {
-    glPushMatrix();
-    glTranslatef(x, y, 0);
-    if (inMenu) glScalef(2.0f, 2.0f, 1.0f); // Bigger in menu
+    const RenderSnapshot& frame = renderSnapshots.front();
+    gfxPushMatrix();
+    gfxTranslatef(x, y, 0);
+    if (inMenu) gfxScalef(2.0f, 2.0f, 1.0f); // Bigger in menu
     
     // Shield effect if active (only in game)
-    if (!inMenu && player.powerUpType == 1) {
-        glColor3f(0.5f, 0.0f, 1.0f);
-        glBegin(GL_LINE_LOOP);
+    if (!inMenu && frame.player.powerUpType == 1) {
+        gfxColor3f(0.5f, 0.0f, 1.0f);
+        gfxBegin(GL_LINE_LOOP);
         for (int i = 0; i < 20; i++) {
             float angle = 2.0f * M_PI * i / 20;
-            glVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
+            gfxVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
     }
     
     // Dress (trapezoid using triangles)
-    glColor3f(0.2f, 0.0f, 0.4f); // Dark purple
-    glBegin(GL_TRIANGLES);
-    glVertex2f(15, 5);  // Top center
-    glVertex2f(5, 25);  // Bottom left
-    glVertex2f(25, 25); // Bottom right
-    glEnd();
-    
-    glBegin(GL_TRIANGLES);
-    glVertex2f(15, 5);  // Top center
-    glVertex2f(10, 5);  // Top left
-    glVertex2f(5, 25);  // Bottom left
-    glEnd();
-    
-    glBegin(GL_TRIANGLES);
-    glVertex2f(15, 5);  // Top center
-    glVertex2f(25, 25); // Bottom right
-    glVertex2f(20, 5);  // Top right
-    glEnd();
+    gfxColor3f(0.2f, 0.0f, 0.4f); // Dark purple
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, 5);  // Top center
+    gfxVertex2f(5, 25);  // Bottom left
+    gfxVertex2f(25, 25); // Bottom right
+    gfxEnd();
+    
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, 5);  // Top center
+    gfxVertex2f(10, 5);  // Top left
+    gfxVertex2f(5, 25);  // Bottom left
+    gfxEnd();
+    
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, 5);  // Top center
+    gfxVertex2f(25, 25); // Bottom right
+    gfxVertex2f(20, 5);  // Top right
+    gfxEnd();
     
     // Witch hat (triangle)
-    glColor3f(0.1f, 0.0f, 0.2f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(15, 45); // Top
-    glVertex2f(8, 25);  // Left
-    glVertex2f(22, 25); // Right
-    glEnd();
+    gfxColor3f(0.1f, 0.0f, 0.2f);
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, 45); // Top
+    gfxVertex2f(8, 25);  // Left
+    gfxVertex2f(22, 25); // Right
+    gfxEnd();
     
     // Hat brim (rectangle)
-    glBegin(GL_QUADS);
-    glVertex2f(6, 25);
-    glVertex2f(24, 25);
-    glVertex2f(24, 28);
-    glVertex2f(6, 28);
-    glEnd();
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(6, 25);
+    gfxVertex2f(24, 25);
+    gfxVertex2f(24, 28);
+    gfxVertex2f(6, 28);
+    gfxEnd();
     
     // Hands (circles)
-    glColor3f(0.8f, 0.6f, 0.4f);
-    glBegin(GL_POLYGON);
+    gfxColor3f(0.8f, 0.6f, 0.4f);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float angle = 2.0f * M_PI * i / 12;
-        glVertex2f(-2 + 3 * cos(angle), 15 + 3 * sin(angle));
+        gfxVertex2f(-2 + 3 * cos(angle), 15 + 3 * sin(angle));
     }
-    glEnd();
+    gfxEnd();
     
-    glBegin(GL_POLYGON);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float angle = 2.0f * M_PI * i / 12;
-        glVertex2f(32 + 3 * cos(angle), 15 + 3 * sin(angle));
+        gfxVertex2f(32 + 3 * cos(angle), 15 + 3 * sin(angle));
     }
-    glEnd();
+    gfxEnd();
     
     // Broomstick (rectangle)
-    glColor3f(0.6f, 0.3f, 0.1f);
-    glBegin(GL_QUADS);
-    glVertex2f(30, 12);
-    glVertex2f(45, 10);
-    glVertex2f(45, 14);
-    glVertex2f(30, 16);
-    glEnd();
+    gfxColor3f(0.6f, 0.3f, 0.1f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(30, 12);
+    gfxVertex2f(45, 10);
+    gfxVertex2f(45, 14);
+    gfxVertex2f(30, 16);
+    gfxEnd();
     
     // Broom bristles (triangles)
-    glColor3f(0.8f, 0.7f, 0.3f);
+    gfxColor3f(0.8f, 0.7f, 0.3f);
     for (int i = 0; i < 3; i++) {
-        glBegin(GL_TRIANGLES);
-        glVertex2f(45, 8 + i * 3);
-        glVertex2f(52, 6 + i * 4);
-        glVertex2f(45, 10 + i * 3);
-        glEnd();
+        gfxBegin(GL_TRIANGLES);
+        gfxVertex2f(45, 8 + i * 3);
+        gfxVertex2f(52, 6 + i * 4);
+        gfxVertex2f(45, 10 + i * 3);
+        gfxEnd();
     }
     
-    glPopMatrix();
+    gfxPopMatrix();
 }
 
 // Draw footballer character (4+ primitives: jersey, shorts, boots, ball)
 void drawFootballer(float x, float y, bool inMenu = false) {
-    glPushMatrix();
-    glTranslatef(x, y, 0);
-    if (inMenu) glScalef(2.0f, 2.0f, 1.0f);
+    const RenderSnapshot& frame = renderSnapshots.front();
+    gfxPushMatrix();
+    gfxTranslatef(x, y, 0);
+    if (inMenu) gfxScalef(2.0f, 2.0f, 1.0f);
     
     // Shield effect if active (only in game)
-    if (!inMenu && player.powerUpType == 1) {
-        glColor3f(0.0f, 1.0f, 1.0f);
-        glBegin(GL_LINE_LOOP);
+    if (!inMenu && frame.player.powerUpType == 1) {
+        gfxColor3f(0.0f, 1.0f, 1.0f);
+        gfxBegin(GL_LINE_LOOP);
         for (int i = 0; i < 20; i++) {
             float angle = 2.0f * M_PI * i / 20;
-            glVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
+            gfxVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
     }
     
     // Jersey (rectangle)
-    glColor3f(0.0f, 0.8f, 0.0f); // Green jersey
-    glBegin(GL_QUADS);
-    glVertex2f(8, 15);
-    glVertex2f(22, 15);
-    glVertex2f(22, 28);
-    glVertex2f(8, 28);
-    glEnd();
+    gfxColor3f(0.0f, 0.8f, 0.0f); // Green jersey
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(8, 15);
+    gfxVertex2f(22, 15);
+    gfxVertex2f(22, 28);
+    gfxVertex2f(8, 28);
+    gfxEnd();
     
     // Jersey number (rectangle)
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(12, 20);
-    glVertex2f(18, 20);
-    glVertex2f(18, 25);
-    glVertex2f(12, 25);
-    glEnd();
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(12, 20);
+    gfxVertex2f(18, 20);
+    gfxVertex2f(18, 25);
+    gfxVertex2f(12, 25);
+    gfxEnd();
     
     // Shorts (rectangle)
-    glColor3f(0.0f, 0.0f, 0.8f); // Blue shorts
-    glBegin(GL_QUADS);
-    glVertex2f(9, 8);
-    glVertex2f(21, 8);
-    glVertex2f(21, 15);
-    glVertex2f(9, 15);
-    glEnd();
+    gfxColor3f(0.0f, 0.0f, 0.8f); // Blue shorts
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(9, 8);
+    gfxVertex2f(21, 8);
+    gfxVertex2f(21, 15);
+    gfxVertex2f(9, 15);
+    gfxEnd();
     
     // Head (circle)
-    glColor3f(1.0f, 0.8f, 0.6f);
-    glBegin(GL_POLYGON);
+    gfxColor3f(1.0f, 0.8f, 0.6f);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 16; i++) {
         float angle = 2.0f * M_PI * i / 16;
-        glVertex2f(15 + 6 * cos(angle), 34 + 6 * sin(angle));
+        gfxVertex2f(15 + 6 * cos(angle), 34 + 6 * sin(angle));
     }
-    glEnd();
+    gfxEnd();
     
     // Arms (rectangles)
-    glColor3f(1.0f, 0.8f, 0.6f);
-    glBegin(GL_QUADS);
-    glVertex2f(4, 20);
-    glVertex2f(8, 20);
-    glVertex2f(8, 26);
-    glVertex2f(4, 26);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    glVertex2f(22, 20);
-    glVertex2f(26, 20);
-    glVertex2f(26, 26);
-    glVertex2f(22, 26);
-    glEnd();
+    gfxColor3f(1.0f, 0.8f, 0.6f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(4, 20);
+    gfxVertex2f(8, 20);
+    gfxVertex2f(8, 26);
+    gfxVertex2f(4, 26);
+    gfxEnd();
+    
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(22, 20);
+    gfxVertex2f(26, 20);
+    gfxVertex2f(26, 26);
+    gfxVertex2f(22, 26);
+    gfxEnd();
     
     // Football boots (rectangles)
-    glColor3f(0.0f, 0.0f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(8, 0);
-    glVertex2f(14, 0);
-    glVertex2f(14, 8);
-    glVertex2f(8, 8);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    glVertex2f(16, 0);
-    glVertex2f(22, 0);
-    glVertex2f(22, 8);
-    glVertex2f(16, 8);
-    glEnd();
+    gfxColor3f(0.0f, 0.0f, 0.0f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(8, 0);
+    gfxVertex2f(14, 0);
+    gfxVertex2f(14, 8);
+    gfxVertex2f(8, 8);
+    gfxEnd();
+    
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(16, 0);
+    gfxVertex2f(22, 0);
+    gfxVertex2f(22, 8);
+    gfxVertex2f(16, 8);
+    gfxEnd();
     
     // Football (circle)
     if (inMenu) {
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(1.0f, 1.0f, 1.0f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 12; i++) {
             float angle = 2.0f * M_PI * i / 12;
-            glVertex2f(35 + 6 * cos(angle), 15 + 6 * sin(angle));
+            gfxVertex2f(35 + 6 * cos(angle), 15 + 6 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Football pattern (lines)
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glBegin(GL_LINES);
-        glVertex2f(32, 15); glVertex2f(38, 15);
-        glVertex2f(35, 12); glVertex2f(35, 18);
-        glEnd();
+        gfxColor3f(0.0f, 0.0f, 0.0f);
+        gfxBegin(GL_LINES);
+        gfxVertex2f(32, 15); gfxVertex2f(38, 15);
+        gfxVertex2f(35, 12); gfxVertex2f(35, 18);
+        gfxEnd();
     }
     
-    glPopMatrix();
+    gfxPopMatrix();
 }
 
 // Draw businessman character (4+ primitives: suit jacket, tie, briefcase, dress shoes)
 void drawBusinessman(float x, float y, bool inMenu = false) {
-    glPushMatrix();
-    glTranslatef(x, y, 0);
-    if (inMenu) glScalef(2.0f, 2.0f, 1.0f);
+    const RenderSnapshot& frame = renderSnapshots.front();
+    gfxPushMatrix();
+    gfxTranslatef(x, y, 0);
+    if (inMenu) gfxScalef(2.0f, 2.0f, 1.0f);
     
     // Shield effect if active (only in game)
-    if (!inMenu && player.powerUpType == 1) {
-        glColor3f(0.0f, 1.0f, 1.0f);
-        glBegin(GL_LINE_LOOP);
+    if (!inMenu && frame.player.powerUpType == 1) {
+        gfxColor3f(0.0f, 1.0f, 1.0f);
+        gfxBegin(GL_LINE_LOOP);
         for (int i = 0; i < 20; i++) {
             float angle = 2.0f * M_PI * i / 20;
-            glVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
+            gfxVertex2f(15 + 25 * cos(angle), 20 + 25 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
     }
     
     // Suit jacket (rectangle)
-    glColor3f(0.2f, 0.2f, 0.2f); // Dark gray suit
-    glBegin(GL_QUADS);
-    glVertex2f(7, 10);
-    glVertex2f(23, 10);
-    glVertex2f(23, 28);
-    glVertex2f(7, 28);
-    glEnd();
+    gfxColor3f(0.2f, 0.2f, 0.2f); // Dark gray suit
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(7, 10);
+    gfxVertex2f(23, 10);
+    gfxVertex2f(23, 28);
+    gfxVertex2f(7, 28);
+    gfxEnd();
     
     // Shirt (rectangle)
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(11, 15);
-    glVertex2f(19, 15);
-    glVertex2f(19, 28);
-    glVertex2f(11, 28);
-    glEnd();
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(11, 15);
+    gfxVertex2f(19, 15);
+    gfxVertex2f(19, 28);
+    gfxVertex2f(11, 28);
+    gfxEnd();
     
     // Tie (triangle)
-    glColor3f(0.8f, 0.0f, 0.0f); // Red tie
-    glBegin(GL_TRIANGLES);
-    glVertex2f(15, 28);
-    glVertex2f(13, 18);
-    glVertex2f(17, 18);
-    glEnd();
+    gfxColor3f(0.8f, 0.0f, 0.0f); // Red tie
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, 28);
+    gfxVertex2f(13, 18);
+    gfxVertex2f(17, 18);
+    gfxEnd();
     
     // Suit pants (rectangle)
-    glColor3f(0.2f, 0.2f, 0.2f);
-    glBegin(GL_QUADS);
-    glVertex2f(9, 2);
-    glVertex2f(21, 2);
-    glVertex2f(21, 10);
-    glVertex2f(9, 10);
-    glEnd();
+    gfxColor3f(0.2f, 0.2f, 0.2f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(9, 2);
+    gfxVertex2f(21, 2);
+    gfxVertex2f(21, 10);
+    gfxVertex2f(9, 10);
+    gfxEnd();
     
     // Head (circle)
-    glColor3f(1.0f, 0.8f, 0.6f);
-    glBegin(GL_POLYGON);
+    gfxColor3f(1.0f, 0.8f, 0.6f);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 16; i++) {
         float angle = 2.0f * M_PI * i / 16;
-        glVertex2f(15 + 6 * cos(angle), 34 + 6 * sin(angle));
+        gfxVertex2f(15 + 6 * cos(angle), 34 + 6 * sin(angle));
     }
-    glEnd();
+    gfxEnd();
     
     // Arms (rectangles)
-    glColor3f(0.2f, 0.2f, 0.2f);
-    glBegin(GL_QUADS);
-    glVertex2f(3, 18);
-    glVertex2f(7, 18);
-    glVertex2f(7, 26);
-    glVertex2f(3, 26);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    glVertex2f(23, 18);
-    glVertex2f(27, 18);
-    glVertex2f(27, 26);
-    glVertex2f(23, 26);
-    glEnd();
+    gfxColor3f(0.2f, 0.2f, 0.2f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(3, 18);
+    gfxVertex2f(7, 18);
+    gfxVertex2f(7, 26);
+    gfxVertex2f(3, 26);
+    gfxEnd();
+    
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(23, 18);
+    gfxVertex2f(27, 18);
+    gfxVertex2f(27, 26);
+    gfxVertex2f(23, 26);
+    gfxEnd();
     
     // Dress shoes (rectangles)
-    glColor3f(0.1f, 0.1f, 0.1f);
-    glBegin(GL_QUADS);
-    glVertex2f(8, 0);
-    glVertex2f(14, 0);
-    glVertex2f(14, 4);
-    glVertex2f(8, 4);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    glVertex2f(16, 0);
-    glVertex2f(22, 0);
-    glVertex2f(22, 4);
-    glVertex2f(16, 4);
-    glEnd();
+    gfxColor3f(0.1f, 0.1f, 0.1f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(8, 0);
+    gfxVertex2f(14, 0);
+    gfxVertex2f(14, 4);
+    gfxVertex2f(8, 4);
+    gfxEnd();
+    
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(16, 0);
+    gfxVertex2f(22, 0);
+    gfxVertex2f(22, 4);
+    gfxVertex2f(16, 4);
+    gfxEnd();
     
     // Briefcase (rectangle)
     if (inMenu) {
-        glColor3f(0.4f, 0.2f, 0.0f);
-        glBegin(GL_QUADS);
-        glVertex2f(30, 12);
-        glVertex2f(42, 12);
-        glVertex2f(42, 20);
-        glVertex2f(30, 20);
-        glEnd();
+        gfxColor3f(0.4f, 0.2f, 0.0f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(30, 12);
+        gfxVertex2f(42, 12);
+        gfxVertex2f(42, 20);
+        gfxVertex2f(30, 20);
+        gfxEnd();
         
         // Briefcase handle (rectangle)
-        glColor3f(0.2f, 0.1f, 0.0f);
-        glBegin(GL_QUADS);
-        glVertex2f(34, 20);
-        glVertex2f(38, 20);
-        glVertex2f(38, 22);
-        glVertex2f(34, 22);
-        glEnd();
+        gfxColor3f(0.2f, 0.1f, 0.0f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(34, 20);
+        gfxVertex2f(38, 20);
+        gfxVertex2f(38, 22);
+        gfxVertex2f(34, 22);
+        gfxEnd();
     }
     
-    glPopMatrix();
+    gfxPopMatrix();
 }
 
 // Draw player based on selected character (with jump flip rotation)
 void drawPlayer() {
-    float pivotX = player.x + player.width / 2.0f;
-    float pivotY = player.y + player.height / 2.0f;
-    glPushMatrix();
-    glTranslatef(pivotX, pivotY, 0);
-    glRotatef(playerFlipAngle, 0, 0, 1); // Negative angles = clockwise
-    glTranslatef(-pivotX, -pivotY, 0);
+    const RenderSnapshot& frame = renderSnapshots.front();
+    float pivotX = frame.player.x + frame.player.width / 2.0f;
+    float pivotY = frame.player.y + frame.player.height / 2.0f;
+    gfxPushMatrix();
+    gfxTranslatef(pivotX, pivotY, 0);
+    gfxRotatef(frame.playerFlipAngle, 0, 0, 1); // Negative angles = clockwise
+    gfxTranslatef(-pivotX, -pivotY, 0);
     
     switch (selectedCharacter) {
         case WITCH:
-            drawWitch(player.x, player.y, false);
+            drawWitch(frame.player.x, frame.player.y, false);
             break;
         case FOOTBALLER:
-            drawFootballer(player.x, player.y, false);
+            drawFootballer(frame.player.x, frame.player.y, false);
             break;
         case BUSINESSMAN:
-            drawBusinessman(player.x, player.y, false);
+            drawBusinessman(frame.player.x, frame.player.y, false);
             break;
     }
-    glPopMatrix();
+    gfxPopMatrix();
 }
 
 // Draw platforms (3+ primitives: rectangle base, triangle decoration, line borders)
 void drawPlatforms() {
-    for (const auto& platform : platforms) {
-        if (!platform.active || platform.y < lavaHeight) continue;
+    const RenderSnapshot& frame = renderSnapshots.front();
+    bool platformDecorations = qualitySettings().platformDecorations;
+    for (const auto& platform : frame.platforms) {
+        if (!platform.active || platform.y < frame.lavaHeight) continue;
         
-        glPushMatrix();
-        glTranslatef(platform.x, platform.y, 0);
+        gfxPushMatrix();
+        gfxTranslatef(platform.x, platform.y, 0);
         
         // Platform base (rectangle)
-        glColor3f(0.4f, 0.8f, 0.2f);
-        glBegin(GL_QUADS);
-        glVertex2f(0, 0);
-        glVertex2f(platform.width, 0);
-        glVertex2f(platform.width, platform.height);
-        glVertex2f(0, platform.height);
-        glEnd();
+        gfxColor3f(0.4f, 0.8f, 0.2f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(0, 0);
+        gfxVertex2f(platform.width, 0);
+        gfxVertex2f(platform.width, platform.height);
+        gfxVertex2f(0, platform.height);
+        gfxEnd();
         
         // Decorative triangles on top
-        glColor3f(0.2f, 0.6f, 0.1f);
-        for (float i = 10; i < platform.width - 10; i += 20) {
-            glBegin(GL_TRIANGLES);
-            glVertex2f(i, platform.height);
-            glVertex2f(i + 5, platform.height + 5);
-            glVertex2f(i + 10, platform.height);
-            glEnd();
+        gfxColor3f(0.2f, 0.6f, 0.1f);
+        for (float i = 10; platformDecorations && i < platform.width - 10; i += 20) {
+            gfxBegin(GL_TRIANGLES);
+            gfxVertex2f(i, platform.height);
+            gfxVertex2f(i + 5, platform.height + 5);
+            gfxVertex2f(i + 10, platform.height);
+            gfxEnd();
         }
         
         // Border lines
-        glColor3f(0.1f, 0.4f, 0.05f);
-        glBegin(GL_LINE_LOOP);
-        glVertex2f(0, 0);
-        glVertex2f(platform.width, 0);
-        glVertex2f(platform.width, platform.height);
-        glVertex2f(0, platform.height);
-        glEnd();
+        gfxColor3f(0.1f, 0.4f, 0.05f);
+        gfxBegin(GL_LINE_LOOP);
+        gfxVertex2f(0, 0);
+        gfxVertex2f(platform.width, 0);
+        gfxVertex2f(platform.width, platform.height);
+        gfxVertex2f(0, platform.height);
+        gfxEnd();
         
-        glPopMatrix();
+        gfxPopMatrix();
     }
 }
 
-// Draw lava (2+ primitives: rectangle base, wavy triangles on top)
+// Draw lava (one triangle strip: body plus wavy crest)
 void drawLava() {
-    // Lava base (rectangle)
-    glColor3f(1.0f, 0.2f, 0.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WIDTH, 0);
-    glVertex2f(WIDTH, lavaHeight);
-    glVertex2f(0, lavaHeight);
-    glEnd();
-    
-    // Wavy flame effect on top (triangles)
-    glColor3f(1.0f, 0.8f, 0.0f);
-    float waveOffset = sin(gameTime * 5) * 5;
-    for (float i = 0; i < WIDTH; i += 20) {
-        float height = 10 + sin((i + gameTime * 100) * 0.1f) * 5;
-        glBegin(GL_TRIANGLES);
-        glVertex2f(i, lavaHeight);
-        glVertex2f(i + 10, lavaHeight + height + waveOffset);
-        glVertex2f(i + 20, lavaHeight);
-        glEnd();
+    const RenderSnapshot& frame = renderSnapshots.front();
+    if (renderBackend == RENDER_CORE) {
+        coreDrawLava(frame.lavaHeight, frame.gameTime);
+        return;
+    }
+    
+    // Crest height is 10 + 5*sin(0.1*x + 10*t) + 5*sin(5*t). The first sine is
+    // expanded with the angle-sum identity so the per-vertex pass is multiply-adds
+    // over flat arrays, which the compiler vectorises; only two sin/cos per frame.
+    float phaseSin = sin(frame.gameTime * 10.0f);
+    float phaseCos = cos(frame.gameTime * 10.0f);
+    float waveOffset = sin(frame.gameTime * 5) * 5;
+    float crestLift = 10.0f + waveOffset;
+    for (int i = 0; i < LAVA_STRIP_VERTICES; i++) {
+        lavaStrip.position[i][1] = lavaStrip.onSurface[i] * frame.lavaHeight + lavaStrip.onCrest[i] * crestLift +
+                                   lavaStrip.crestSin[i] * phaseCos + lavaStrip.crestCos[i] * phaseSin;
     }
+    
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, lavaStrip.position);
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, lavaStrip.color);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, LAVA_STRIP_VERTICES);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 // Draw rocks (2+ primitives: hexagon body, triangle spike)
 void drawRocks() {
-    for (const auto& rock : rocks) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    for (const auto& rock : frame.rocks) {
         if (!rock.active) continue;
         
-        glPushMatrix();
-        glTranslatef(rock.x, rock.y, 0);
+        gfxPushMatrix();
+        gfxTranslatef(rock.x, rock.y, 0);
         
         // Rock body (hexagon)
-        glColor3f(0.6f, 0.4f, 0.2f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.6f, 0.4f, 0.2f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 6; i++) {
             float angle = i * M_PI / 3;
-            glVertex2f(10 * cos(angle), 10 * sin(angle));
+            gfxVertex2f(10 * cos(angle), 10 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Dangerous spike (triangle)
-        glColor3f(0.8f, 0.2f, 0.2f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(0, 12);
-        glVertex2f(-5, 5);
-        glVertex2f(5, 5);
-        glEnd();
+        gfxColor3f(0.8f, 0.2f, 0.2f);
+        gfxBegin(GL_TRIANGLES);
+        gfxVertex2f(0, 12);
+        gfxVertex2f(-5, 5);
+        gfxVertex2f(5, 5);
+        gfxEnd();
         
-        glPopMatrix();
+        gfxPopMatrix();
+    }
+}
+
+// Sprite atlas: the pickups and HUD icons are rasterised once at startup into
+// one premultiplied-alpha texture, then each item is drawn as a single quad.
+// The coin's Y-flip squash is baked as a row of frames.
+const int COIN_FRAME_COUNT = 12;
+
+enum AtlasSprite {
+    SPRITE_COIN_FIRST,                                // Squash frames, edge-on to face-on
+    SPRITE_KEY = SPRITE_COIN_FIRST + COIN_FRAME_COUNT,
+    SPRITE_SHIELD,
+    SPRITE_WINGS,
+    SPRITE_HEART_ICON,
+    SPRITE_COIN_ICON,
+    SPRITE_KEY_ICON,
+    SPRITE_COUNT
+};
+
+struct AtlasRegion {
+    float u0, v0, u1, v1;
+    float halfSize;  // Half the quad's side in world units at scale 1
+};
+
+struct SpriteAtlas {
+    GLuint texture = 0;        // 0 = not built; items are drawn from primitives
+    bool enabled = true;       // Cleared by --no-atlas
+    AtlasRegion regions[SPRITE_COUNT];
+} atlas;
+
+// One textured quad centred on (x, y) in the current transform
+void drawSprite(int sprite, float x, float y, float scale) {
+    const AtlasRegion& region = atlas.regions[sprite];
+    float h = region.halfSize * scale;
+    gfxBegin(GL_QUADS);
+    gfxTexCoord2f(region.u0, region.v0); gfxVertex2f(x - h, y - h);
+    gfxTexCoord2f(region.u1, region.v0); gfxVertex2f(x + h, y - h);
+    gfxTexCoord2f(region.u1, region.v1); gfxVertex2f(x + h, y + h);
+    gfxTexCoord2f(region.u0, region.v1); gfxVertex2f(x - h, y + h);
+    gfxEnd();
+}
+
+// Coin artwork at the origin; t is the flip phase (0 = edge-on, 1 = face-on)
+void drawCoinArt(float t, int segments) {
+    gfxPushMatrix();
+    
+    // Y-axis flip illusion using X-scale squash and overall size modulation
+    float xScale = 0.25f + 0.75f * t; // Thin at edge, full when face-on
+    float overall = 0.8f + 0.4f * t;  // Larger when face-on
+    gfxScalef(overall * xScale, overall, 1.0f);
+
+    // Base coin (ellipse due to X scaling) - PRIMITIVE 1: Polygon - Updated to cyan/turquoise
+    gfxColor3f(0.2f, 0.9f, 0.95f);
+    gfxBegin(GL_POLYGON);
+    for (int i = 0; i < segments; i++) {
+        float angle = 2.0f * M_PI * i / segments;
+        gfxVertex2f(10.0f * cosf(angle), 10.0f * sinf(angle));
+    }
+    gfxEnd();
+
+    // Rim ring - PRIMITIVE 2: Line loop - Lighter cyan
+    gfxColor3f(0.5f, 1.0f, 1.0f);
+    gfxBegin(GL_LINE_LOOP);
+    for (int i = 0; i < segments; i++) {
+        float angle = 2.0f * M_PI * i / segments;
+        gfxVertex2f(9.0f * cosf(angle), 9.0f * sinf(angle));
     }
+    gfxEnd();
+
+    // Radial highlight - PRIMITIVE 3: Triangle fan gradient - Bright cyan to aqua
+    gfxBegin(GL_TRIANGLE_FAN);
+    gfxColor3f(0.8f, 1.0f, 1.0f); // center bright aqua
+    gfxVertex2f(0.0f, 0.0f); // centered for Y-axis rotation
+    gfxColor3f(0.1f, 0.85f, 0.95f); // outer cyan
+    for (int i = 0; i <= segments; i++) {
+        float angle = 2.0f * M_PI * i / segments;
+        gfxVertex2f(10.0f * cosf(angle), 10.0f * sinf(angle));
+    }
+    gfxEnd();
+
+    // Specular streak across face - PRIMITIVE 4: Quad
+    gfxColor4f(1.0f, 1.0f, 1.0f, 0.35f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(-7.0f, 3.0f);
+    gfxVertex2f(7.0f, 3.0f);
+    gfxVertex2f(7.0f, 1.0f);
+    gfxVertex2f(-7.0f, 1.0f);
+    gfxEnd();
+
+    // Edge darkening when thin (simulates depth) - Darker cyan
+    float edgeAlpha = 1.0f - t; // stronger when thinner
+    gfxColor4f(0.1f, 0.5f, 0.6f, 0.4f * edgeAlpha);
+    gfxBegin(GL_LINE_LOOP);
+    for (int i = 0; i < segments; i++) {
+        float angle = 2.0f * M_PI * i / segments;
+        gfxVertex2f(10.5f * cosf(angle), 10.5f * sinf(angle));
+    }
+    gfxEnd();
+
+    gfxPopMatrix();
 }
 
 // Draw collectables with 3D-like Y-axis rotation illusion (3+ primitives: circle, line loop, triangle fan, quad)
 void drawCollectables() {
-    for (const auto& collectable : collectables) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    int segments = qualitySettings().coinSegments;
+    if (atlas.texture) gfxBeginPremultiplied(atlas.texture);
+    for (const auto& collectable : frame.collectables) {
         if (collectable.collected) continue;
 
-        glPushMatrix();
-
         // Horizontal movement for odd-numbered coins (±20 pixels max)
         float horizontalOffset = 0.0f;
         if (collectable.index % 2 == 1) {
             horizontalOffset = sinf(collectable.animTime * 2.0f) * 20.0f;
         }
 
-        glTranslatef(collectable.x + horizontalOffset, collectable.y, 0);
-
-        // Y-axis flip illusion using X-scale squash and overall size modulation
         float t = (sinf(collectable.animTime * 4.0f) + 1.0f) * 0.5f; // 0..1
-        float xScale = 0.25f + 0.75f * t; // Thin at edge, full when face-on
-        float overall = 0.8f + 0.4f * t;  // Larger when face-on
-        glScalef(overall * xScale, overall, 1.0f);
-
-        // Base coin (ellipse due to X scaling) - PRIMITIVE 1: Polygon - Updated to cyan/turquoise
-        glColor3f(0.2f, 0.9f, 0.95f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 24; i++) {
-            float angle = 2.0f * M_PI * i / 24;
-            glVertex2f(10.0f * cosf(angle), 10.0f * sinf(angle));
-        }
-        glEnd();
-
-        // Rim ring - PRIMITIVE 2: Line loop - Lighter cyan
-        glColor3f(0.5f, 1.0f, 1.0f);
-        glBegin(GL_LINE_LOOP);
-        for (int i = 0; i < 24; i++) {
-            float angle = 2.0f * M_PI * i / 24;
-            glVertex2f(9.0f * cosf(angle), 9.0f * sinf(angle));
-        }
-        glEnd();
-
-        // Radial highlight - PRIMITIVE 3: Triangle fan gradient - Bright cyan to aqua
-        glBegin(GL_TRIANGLE_FAN);
-        glColor3f(0.8f, 1.0f, 1.0f); // center bright aqua
-        glVertex2f(0.0f, 0.0f); // centered for Y-axis rotation
-        glColor3f(0.1f, 0.85f, 0.95f); // outer cyan
-        for (int i = 0; i <= 24; i++) {
-            float angle = 2.0f * M_PI * i / 24;
-            glVertex2f(10.0f * cosf(angle), 10.0f * sinf(angle));
-        }
-        glEnd();
-
-        // Specular streak across face - PRIMITIVE 4: Quad
-        glColor4f(1.0f, 1.0f, 1.0f, 0.35f);
-        glBegin(GL_QUADS);
-        glVertex2f(-7.0f, 3.0f);
-        glVertex2f(7.0f, 3.0f);
-        glVertex2f(7.0f, 1.0f);
-        glVertex2f(-7.0f, 1.0f);
-        glEnd();
-
-        // Edge darkening when thin (simulates depth) - Darker cyan
-        float edgeAlpha = 1.0f - t; // stronger when thinner
-        glColor4f(0.1f, 0.5f, 0.6f, 0.4f * edgeAlpha);
-        glBegin(GL_LINE_LOOP);
-        for (int i = 0; i < 24; i++) {
-            float angle = 2.0f * M_PI * i / 24;
-            glVertex2f(10.5f * cosf(angle), 10.5f * sinf(angle));
-        }
-        glEnd();
-
-        glPopMatrix();
+        if (atlas.texture) {
+            int frame = (int)(t * (COIN_FRAME_COUNT - 1) + 0.5f);
+            drawSprite(SPRITE_COIN_FIRST + frame, collectable.x + horizontalOffset, collectable.y, 1.0f);
+        } else {
+            gfxPushMatrix();
+            gfxTranslatef(collectable.x + horizontalOffset, collectable.y, 0);
+            drawCoinArt(t, segments);
+            gfxPopMatrix();
+        }
     }
+    if (atlas.texture) gfxEndPremultiplied();
 }
 
-// Draw key (4+ primitives: rectangle shaft, circle head, triangle teeth, line handle)
-void drawKey() {
-    if (!keySpawned || keyCollected) return;
-    
-    glPushMatrix();
-    glTranslatef(keyX, keyY, 0);
-    glRotatef(sin(keyAnimTime * 3) * 10, 0, 0, 1);
-    float scale = 1.0f + 0.1f * sin(keyAnimTime * 4);
-    glScalef(scale, scale, 1);
-    
+// Key artwork at the origin
+void drawKeyArt() {
     // Key shaft (rectangle) - Updated to silver/purple
-    glColor3f(0.85f, 0.6f, 0.95f);
-    glBegin(GL_QUADS);
-    glVertex2f(-15, -2);
-    glVertex2f(5, -2);
-    glVertex2f(5, 2);
-    glVertex2f(-15, 2);
-    glEnd();
+    gfxColor3f(0.85f, 0.6f, 0.95f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(-15, -2);
+    gfxVertex2f(5, -2);
+    gfxVertex2f(5, 2);
+    gfxVertex2f(-15, 2);
+    gfxEnd();
     
     // Key head (circle) - Lighter purple
-    glColor3f(0.95f, 0.75f, 1.0f);
-    glBegin(GL_POLYGON);
+    gfxColor3f(0.95f, 0.75f, 1.0f);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float angle = 2.0f * M_PI * i / 12;
-        glVertex2f(-15 + 6 * cos(angle), 6 * sin(angle));
+        gfxVertex2f(-15 + 6 * cos(angle), 6 * sin(angle));
     }
-    glEnd();
+    gfxEnd();
     
     // Key teeth (triangles) - Medium purple
-    glColor3f(0.85f, 0.6f, 0.95f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(5, -2);
-    glVertex2f(10, -2);
-    glVertex2f(10, 0);
-    glEnd();
-    
-    glBegin(GL_TRIANGLES);
-    glVertex2f(5, 2);
-    glVertex2f(8, 2);
-    glVertex2f(8, 0);
-    glEnd();
+    gfxColor3f(0.85f, 0.6f, 0.95f);
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(5, -2);
+    gfxVertex2f(10, -2);
+    gfxVertex2f(10, 0);
+    gfxEnd();
+    
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(5, 2);
+    gfxVertex2f(8, 2);
+    gfxVertex2f(8, 0);
+    gfxEnd();
     
     // Handle decoration (line) - Darker purple
-    glColor3f(0.6f, 0.3f, 0.8f);
-    glBegin(GL_LINES);
-    glVertex2f(-15, -4);
-    glVertex2f(-15, 4);
-    glEnd();
+    gfxColor3f(0.6f, 0.3f, 0.8f);
+    gfxBegin(GL_LINES);
+    gfxVertex2f(-15, -4);
+    gfxVertex2f(-15, 4);
+    gfxEnd();
+}
+
+// Draw key (4+ primitives: rectangle shaft, circle head, triangle teeth, line handle)
+void drawKey() {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    if (!frame.keySpawned || frame.keyCollected) return;
+    
+    gfxPushMatrix();
+    gfxTranslatef(frame.keyX, frame.keyY, 0);
+    gfxRotatef(sin(frame.keyAnimTime * 3) * 10, 0, 0, 1);
+    float scale = 1.0f + 0.1f * sin(frame.keyAnimTime * 4);
+    gfxScalef(scale, scale, 1);
+    
+    if (atlas.texture) {
+        gfxBeginPremultiplied(atlas.texture);
+        drawSprite(SPRITE_KEY, 0, 0, 1.0f);
+        gfxEndPremultiplied();
+    } else {
+        drawKeyArt();
+    }
     
-    glPopMatrix();
+    gfxPopMatrix();
 }
 
 // Draw epic animated door
 void drawDoor() {
+    const RenderSnapshot& frame = renderSnapshots.front();
     float doorX = WIDTH / 2 - 40;
     float doorY = HEIGHT - 150; // Positioned at the very top of the game area
     
-    glPushMatrix();
-    glTranslatef(doorX, doorY, 0);
+    gfxPushMatrix();
+    gfxTranslatef(doorX, doorY, 0);
     
-    if (keyCollected || doorIsUnlocking) {
+    if (frame.keyCollected || frame.doorIsUnlocking) {
         // Unlocked/Unlocking door with animations
-        float unlockProgress = doorIsUnlocking ? std::min(1.0f, doorUnlockAnimTime / 2.0f) : 1.0f;
-        float enterProgress = doorIsEntering ? std::min(1.0f, doorEnterAnimTime / 1.5f) : 0.0f;
+        float unlockProgress = frame.doorIsUnlocking ? std::min(1.0f, frame.doorUnlockAnimTime / 2.0f) : 1.0f;
+        float enterProgress = frame.doorIsEntering ? std::min(1.0f, frame.doorEnterAnimTime / 1.5f) : 0.0f;
         
         // Magical portal frame (hexagon)
-        glColor3f(0.2f + unlockProgress * 0.6f, 0.8f, 0.2f + unlockProgress * 0.6f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.2f + unlockProgress * 0.6f, 0.8f, 0.2f + unlockProgress * 0.6f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 6; i++) {
             float angle = M_PI / 2 + i * M_PI / 3;
-            glVertex2f(40 + 45 * cos(angle), 60 + 50 * sin(angle));
+            gfxVertex2f(40 + 45 * cos(angle), 60 + 50 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Inner portal (darker hexagon)
-        glColor3f(0.1f, 0.3f, 0.1f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.1f, 0.3f, 0.1f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 6; i++) {
             float angle = M_PI / 2 + i * M_PI / 3;
-            glVertex2f(40 + 38 * cos(angle), 60 + 43 * sin(angle));
+            gfxVertex2f(40 + 38 * cos(angle), 60 + 43 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Swirling energy vortex
-        for (int layer = 0; layer < 3; layer++) {
+        int vortexLayers = qualitySettings().vortexLayers;
+        for (int layer = 0; layer < vortexLayers; layer++) {
             float layerOffset = layer * 0.5f;
-            float rotation = doorAnimTime * 2.0f + layerOffset;
+            float rotation = frame.doorAnimTime * 2.0f + layerOffset;
             float radius = 35 - layer * 8;
             float alpha = 0.3f - layer * 0.08f;
             
-            glColor4f(0.2f + unlockProgress * 0.5f, 1.0f, 0.2f + unlockProgress * 0.5f, alpha * unlockProgress);
+            gfxColor4f(0.2f + unlockProgress * 0.5f, 1.0f, 0.2f + unlockProgress * 0.5f, alpha * unlockProgress);
             
             for (int i = 0; i < 8; i++) {
                 float angle1 = rotation + i * M_PI / 4;
                 float angle2 = rotation + (i + 0.5f) * M_PI / 4;
                 
-                glBegin(GL_TRIANGLES);
-                glVertex2f(40, 60);
-                glVertex2f(40 + radius * cos(angle1), 60 + radius * sin(angle1));
-                glVertex2f(40 + radius * cos(angle2), 60 + radius * sin(angle2));
-                glEnd();
+                gfxBegin(GL_TRIANGLES);
+                gfxVertex2f(40, 60);
+                gfxVertex2f(40 + radius * cos(angle1), 60 + radius * sin(angle1));
+                gfxVertex2f(40 + radius * cos(angle2), 60 + radius * sin(angle2));
+                gfxEnd();
             }
         }
         
         // Pulsing outer glow rings
-        float pulseSize = sin(doorAnimTime * 3.0f) * 5 + 50;
-        float pulseAlpha = (sin(doorAnimTime * 3.0f) * 0.3f + 0.5f) * unlockProgress;
+        float pulseSize = sin(frame.doorAnimTime * 3.0f) * 5 + 50;
+        float pulseAlpha = (sin(frame.doorAnimTime * 3.0f) * 0.3f + 0.5f) * unlockProgress;
         
-        glColor4f(0.0f, 1.0f, 0.0f, pulseAlpha);
-        glBegin(GL_LINE_LOOP);
+        gfxColor4f(0.0f, 1.0f, 0.0f, pulseAlpha);
+        gfxBegin(GL_LINE_LOOP);
         for (int i = 0; i < 20; i++) {
             float angle = 2.0f * M_PI * i / 20;
-            glVertex2f(40 + pulseSize * cos(angle), 60 + pulseSize * sin(angle));
+            gfxVertex2f(40 + pulseSize * cos(angle), 60 + pulseSize * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
-        glColor4f(0.0f, 1.0f, 0.5f, pulseAlpha * 0.6f);
-        glBegin(GL_LINE_LOOP);
+        gfxColor4f(0.0f, 1.0f, 0.5f, pulseAlpha * 0.6f);
+        gfxBegin(GL_LINE_LOOP);
         for (int i = 0; i < 20; i++) {
             float angle = 2.0f * M_PI * i / 20;
-            glVertex2f(40 + (pulseSize + 5) * cos(angle), 60 + (pulseSize + 5) * sin(angle));
+            gfxVertex2f(40 + (pulseSize + 5) * cos(angle), 60 + (pulseSize + 5) * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Entrance animation - player being sucked in
-        if (doorIsEntering) {
+        if (frame.doorIsEntering) {
             // Bright flash effect
-            glColor4f(1.0f, 1.0f, 1.0f, (1.0f - enterProgress) * 0.7f);
-            glBegin(GL_POLYGON);
+            gfxColor4f(1.0f, 1.0f, 1.0f, (1.0f - enterProgress) * 0.7f);
+            gfxBegin(GL_POLYGON);
             for (int i = 0; i < 12; i++) {
                 float angle = 2.0f * M_PI * i / 12;
                 float flashRadius = 60 * (1.0f - enterProgress);
-                glVertex2f(40 + flashRadius * cos(angle), 60 + flashRadius * sin(angle));
+                gfxVertex2f(40 + flashRadius * cos(angle), 60 + flashRadius * sin(angle));
             }
-            glEnd();
+            gfxEnd();
             
             // Spiraling particles being sucked in
             for (int i = 0; i < 12; i++) {
-                float particleAngle = doorEnterAnimTime * 5.0f + i * M_PI / 6;
+                float particleAngle = frame.doorEnterAnimTime * 5.0f + i * M_PI / 6;
                 float particleRadius = 70 * (1.0f - enterProgress);
                 
-                glColor4f(1.0f, 1.0f, 0.0f, 1.0f - enterProgress);
-                glBegin(GL_POLYGON);
+                gfxColor4f(1.0f, 1.0f, 0.0f, 1.0f - enterProgress);
+                gfxBegin(GL_POLYGON);
                 for (int j = 0; j < 6; j++) {
                     float angle = 2.0f * M_PI * j / 6;
-                    glVertex2f(40 + particleRadius * cos(particleAngle) + 4 * cos(angle),
+                    gfxVertex2f(40 + particleRadius * cos(particleAngle) + 4 * cos(angle),
                               60 + particleRadius * sin(particleAngle) + 4 * sin(angle));
                 }
-                glEnd();
+                gfxEnd();
             }
         }
         
         // Unlock animation - expanding energy waves
-        if (doorIsUnlocking && doorUnlockAnimTime < 2.0f) {
+        if (frame.doorIsUnlocking && frame.doorUnlockAnimTime < 2.0f) {
             for (int wave = 0; wave < 3; wave++) {
-                float waveTime = doorUnlockAnimTime - wave * 0.3f;
+                float waveTime = frame.doorUnlockAnimTime - wave * 0.3f;
                 if (waveTime > 0) {
                     float waveRadius = waveTime * 50;
                     float waveAlpha = std::max(0.0f, 1.0f - waveTime / 2.0f);
                     
-                    glColor4f(1.0f, 1.0f, 0.0f, waveAlpha * 0.6f);
-                    glBegin(GL_LINE_LOOP);
+                    gfxColor4f(1.0f, 1.0f, 0.0f, waveAlpha * 0.6f);
+                    gfxBegin(GL_LINE_LOOP);
                     for (int i = 0; i < 24; i++) {
                         float angle = 2.0f * M_PI * i / 24;
-                        glVertex2f(40 + waveRadius * cos(angle), 60 + waveRadius * sin(angle));
+                        gfxVertex2f(40 + waveRadius * cos(angle), 60 + waveRadius * sin(angle));
                     }
-                    glEnd();
+                    gfxEnd();
                 }
             }
         }
@@ -1348,253 +4545,284 @@ void drawDoor() {
     } else {
         // Locked door - ancient magical sealed door
         // Stone archway frame (trapezoid)
-        glColor3f(0.4f, 0.4f, 0.5f);
-        glBegin(GL_QUADS);
-        glVertex2f(5, 0);
-        glVertex2f(75, 0);
-        glVertex2f(70, 110);
-        glVertex2f(10, 110);
-        glEnd();
+        gfxColor3f(0.4f, 0.4f, 0.5f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(5, 0);
+        gfxVertex2f(75, 0);
+        gfxVertex2f(70, 110);
+        gfxVertex2f(10, 110);
+        gfxEnd();
         
         // Arch top (semi-circle)
-        glBegin(GL_POLYGON);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i <= 10; i++) {
             float angle = M_PI * i / 10;
-            glVertex2f(40 + 30 * cos(angle), 110 + 30 * sin(angle));
+            gfxVertex2f(40 + 30 * cos(angle), 110 + 30 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Inner door surface (darker)
-        glColor3f(0.2f, 0.15f, 0.3f);
-        glBegin(GL_QUADS);
-        glVertex2f(15, 5);
-        glVertex2f(65, 5);
-        glVertex2f(62, 105);
-        glVertex2f(18, 105);
-        glEnd();
+        gfxColor3f(0.2f, 0.15f, 0.3f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(15, 5);
+        gfxVertex2f(65, 5);
+        gfxVertex2f(62, 105);
+        gfxVertex2f(18, 105);
+        gfxEnd();
         
         // Door panels (rectangles)
-        glColor3f(0.25f, 0.2f, 0.35f);
-        glBegin(GL_QUADS);
-        glVertex2f(20, 10);
-        glVertex2f(35, 10);
-        glVertex2f(35, 50);
-        glVertex2f(20, 50);
-        glEnd();
-        
-        glBegin(GL_QUADS);
-        glVertex2f(45, 10);
-        glVertex2f(60, 10);
-        glVertex2f(60, 50);
-        glVertex2f(45, 50);
-        glEnd();
-        
-        glBegin(GL_QUADS);
-        glVertex2f(20, 60);
-        glVertex2f(35, 60);
-        glVertex2f(35, 100);
-        glVertex2f(20, 100);
-        glEnd();
-        
-        glBegin(GL_QUADS);
-        glVertex2f(45, 60);
-        glVertex2f(60, 60);
-        glVertex2f(60, 100);
-        glVertex2f(45, 100);
-        glEnd();
+        gfxColor3f(0.25f, 0.2f, 0.35f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(20, 10);
+        gfxVertex2f(35, 10);
+        gfxVertex2f(35, 50);
+        gfxVertex2f(20, 50);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(45, 10);
+        gfxVertex2f(60, 10);
+        gfxVertex2f(60, 50);
+        gfxVertex2f(45, 50);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(20, 60);
+        gfxVertex2f(35, 60);
+        gfxVertex2f(35, 100);
+        gfxVertex2f(20, 100);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(45, 60);
+        gfxVertex2f(60, 60);
+        gfxVertex2f(60, 100);
+        gfxVertex2f(45, 100);
+        gfxEnd();
         
         // Mystical seal/lock in center (circle with runes)
-        glColor3f(0.6f, 0.3f, 0.8f); // Purple glow
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.6f, 0.3f, 0.8f); // Purple glow
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 16; i++) {
             float angle = 2.0f * M_PI * i / 16;
-            glVertex2f(40 + 15 * cos(angle), 55 + 15 * sin(angle));
+            gfxVertex2f(40 + 15 * cos(angle), 55 + 15 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Inner seal
-        glColor3f(0.4f, 0.2f, 0.6f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.4f, 0.2f, 0.6f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 16; i++) {
             float angle = 2.0f * M_PI * i / 16;
-            glVertex2f(40 + 10 * cos(angle), 55 + 10 * sin(angle));
+            gfxVertex2f(40 + 10 * cos(angle), 55 + 10 * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Keyhole (star shape)
-        glColor3f(0.1f, 0.0f, 0.2f);
-        glBegin(GL_POLYGON);
+        gfxColor3f(0.1f, 0.0f, 0.2f);
+        gfxBegin(GL_POLYGON);
         for (int i = 0; i < 8; i++) {
             float angle = 2.0f * M_PI * i / 8;
             float radius = (i % 2 == 0) ? 6.0f : 3.0f;
-            glVertex2f(40 + radius * cos(angle), 55 + radius * sin(angle));
+            gfxVertex2f(40 + radius * cos(angle), 55 + radius * sin(angle));
         }
-        glEnd();
+        gfxEnd();
         
         // Pulsing magical chains/runes around door
-        float runeGlow = sin(doorAnimTime * 2.0f) * 0.3f + 0.5f;
-        glColor4f(0.8f, 0.3f, 1.0f, runeGlow);
+        float runeGlow = sin(frame.doorAnimTime * 2.0f) * 0.3f + 0.5f;
+        gfxColor4f(0.8f, 0.3f, 1.0f, runeGlow);
         
         // Rune symbols (simple geometric shapes)
         for (int i = 0; i < 4; i++) {
             float runeX = (i % 2 == 0) ? 10 : 70;
             float runeY = 30 + (i / 2) * 50;
             
-            glBegin(GL_LINE_LOOP);
+            gfxBegin(GL_LINE_LOOP);
             for (int j = 0; j < 3; j++) {
-                float angle = 2.0f * M_PI * j / 3 + doorAnimTime;
-                glVertex2f(runeX + 5 * cos(angle), runeY + 5 * sin(angle));
+                float angle = 2.0f * M_PI * j / 3 + frame.doorAnimTime;
+                gfxVertex2f(runeX + 5 * cos(angle), runeY + 5 * sin(angle));
             }
-            glEnd();
+            gfxEnd();
         }
     }
     
-    glPopMatrix();
+    gfxPopMatrix();
+}
+
+// Shield power-up artwork at the origin
+void drawShieldArt() {
+    // Shield base (hexagon)
+    gfxColor3f(0.0f, 0.8f, 1.0f);
+    gfxBegin(GL_POLYGON);
+    for (int i = 0; i < 6; i++) {
+        float angle = i * M_PI / 3;
+        gfxVertex2f(10 * cos(angle), 10 * sin(angle));
+    }
+    gfxEnd();
+    
+    // Shield cross (lines)
+    gfxColor3f(1.0f, 1.0f, 1.0f);
+    gfxBegin(GL_LINES);
+    gfxVertex2f(-8, 0); gfxVertex2f(8, 0);
+    gfxVertex2f(0, -8); gfxVertex2f(0, 8);
+    gfxEnd();
+    
+    // Outer glow (triangle)
+    gfxColor3f(0.5f, 0.9f, 1.0f);
+    for (int i = 0; i < 6; i++) {
+        float angle = i * M_PI / 3;
+        gfxBegin(GL_TRIANGLES);
+        gfxVertex2f(0, 0);
+        gfxVertex2f(12 * cos(angle), 12 * sin(angle));
+        gfxVertex2f(12 * cos(angle + M_PI/3), 12 * sin(angle + M_PI/3));
+        gfxEnd();
+    }
+}
+
+// Double jump power-up artwork at the origin
+void drawWingsArt() {
+    // Wing base (triangles)
+    gfxColor3f(1.0f, 0.8f, 0.2f);
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(-15, -5);
+    gfxVertex2f(-5, 5);
+    gfxVertex2f(-15, 10);
+    gfxEnd();
+    
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(15, -5);
+    gfxVertex2f(5, 5);
+    gfxVertex2f(15, 10);
+    gfxEnd();
+    
+    // Center orb (circle)
+    gfxColor3f(1.0f, 1.0f, 0.0f);
+    gfxBegin(GL_POLYGON);
+    for (int i = 0; i < 12; i++) {
+        float angle = 2.0f * M_PI * i / 12;
+        gfxVertex2f(6 * cos(angle), 6 * sin(angle));
+    }
+    gfxEnd();
+    
+    // Speed lines (lines)
+    gfxColor3f(1.0f, 0.9f, 0.7f);
+    gfxBegin(GL_LINES);
+    for (int i = 0; i < 4; i++) {
+        float angle = i * M_PI / 2;
+        gfxVertex2f(8 * cos(angle), 8 * sin(angle));
+        gfxVertex2f(15 * cos(angle), 15 * sin(angle));
+    }
+    gfxEnd();
 }
 
 // Draw power-ups
 void drawPowerUps() {
-    for (const auto& powerUp : powerUps) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    if (atlas.texture) gfxBeginPremultiplied(atlas.texture);
+    for (const auto& powerUp : frame.powerUps) {
         if (!powerUp.active) continue;
         
-        glPushMatrix();
-        glTranslatef(powerUp.x, powerUp.y, 0);
+        gfxPushMatrix();
+        gfxTranslatef(powerUp.x, powerUp.y, 0);
         float bob = sin(powerUp.animTime * 3) * 3;
-        glTranslatef(0, bob, 0);
-        glRotatef(powerUp.animTime * 50, 0, 0, 1);
-        
-        if (powerUp.type == 1) { // Shield power-up
-            // Shield base (hexagon)
-            glColor3f(0.0f, 0.8f, 1.0f);
-            glBegin(GL_POLYGON);
-            for (int i = 0; i < 6; i++) {
-                float angle = i * M_PI / 3;
-                glVertex2f(10 * cos(angle), 10 * sin(angle));
-            }
-            glEnd();
-            
-            // Shield cross (lines)
-            glColor3f(1.0f, 1.0f, 1.0f);
-            glBegin(GL_LINES);
-            glVertex2f(-8, 0); glVertex2f(8, 0);
-            glVertex2f(0, -8); glVertex2f(0, 8);
-            glEnd();
-            
-            // Outer glow (triangle)
-            glColor3f(0.5f, 0.9f, 1.0f);
-            for (int i = 0; i < 6; i++) {
-                float angle = i * M_PI / 3;
-                glBegin(GL_TRIANGLES);
-                glVertex2f(0, 0);
-                glVertex2f(12 * cos(angle), 12 * sin(angle));
-                glVertex2f(12 * cos(angle + M_PI/3), 12 * sin(angle + M_PI/3));
-                glEnd();
-            }
+        gfxTranslatef(0, bob, 0);
+        gfxRotatef(powerUp.animTime * 50, 0, 0, 1);
+        
+        if (atlas.texture) {
+            drawSprite(powerUp.type == 1 ? SPRITE_SHIELD : SPRITE_WINGS, 0, 0, 1.0f);
+        } else if (powerUp.type == 1) { // Shield power-up
+            drawShieldArt();
         } else if (powerUp.type == 2) { // Double jump power-up
-            // Wing base (triangles)
-            glColor3f(1.0f, 0.8f, 0.2f);
-            glBegin(GL_TRIANGLES);
-            glVertex2f(-15, -5);
-            glVertex2f(-5, 5);
-            glVertex2f(-15, 10);
-            glEnd();
-            
-            glBegin(GL_TRIANGLES);
-            glVertex2f(15, -5);
-            glVertex2f(5, 5);
-            glVertex2f(15, 10);
-            glEnd();
-            
-            // Center orb (circle)
-            glColor3f(1.0f, 1.0f, 0.0f);
-            glBegin(GL_POLYGON);
-            for (int i = 0; i < 12; i++) {
-                float angle = 2.0f * M_PI * i / 12;
-                glVertex2f(6 * cos(angle), 6 * sin(angle));
-            }
-            glEnd();
-            
-            // Speed lines (lines)
-            glColor3f(1.0f, 0.9f, 0.7f);
-            glBegin(GL_LINES);
-            for (int i = 0; i < 4; i++) {
-                float angle = i * M_PI / 2;
-                glVertex2f(8 * cos(angle), 8 * sin(angle));
-                glVertex2f(15 * cos(angle), 15 * sin(angle));
-            }
-            glEnd();
+            drawWingsArt();
         }
         
-        glPopMatrix();
+        gfxPopMatrix();
     }
+    if (atlas.texture) gfxEndPremultiplied();
 }
 
 // Simple icons for HUD
-void drawHeartIcon(float x, float y, float s) {
-    glColor3f(0.9f, 0.1f, 0.2f);
+void drawHeartIconArt(float x, float y, float s) {
+    gfxColor3f(0.9f, 0.1f, 0.2f);
     // Left lobe
-    glBegin(GL_POLYGON);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float a = 2.0f * M_PI * i / 12;
-        glVertex2f(x - 3*s + 3*s * cos(a), y + 2*s + 3*s * sin(a));
+        gfxVertex2f(x - 3*s + 3*s * cos(a), y + 2*s + 3*s * sin(a));
     }
-    glEnd();
+    gfxEnd();
     // Right lobe
-    glBegin(GL_POLYGON);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float a = 2.0f * M_PI * i / 12;
-        glVertex2f(x + 3*s + 3*s * cos(a), y + 2*s + 3*s * sin(a));
+        gfxVertex2f(x + 3*s + 3*s * cos(a), y + 2*s + 3*s * sin(a));
     }
-    glEnd();
+    gfxEnd();
     // Bottom triangle
-    glBegin(GL_TRIANGLES);
-    glVertex2f(x - 6*s, y + 2*s);
-    glVertex2f(x + 6*s, y + 2*s);
-    glVertex2f(x, y - 6*s);
-    glEnd();
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(x - 6*s, y + 2*s);
+    gfxVertex2f(x + 6*s, y + 2*s);
+    gfxVertex2f(x, y - 6*s);
+    gfxEnd();
 }
 
-void drawCoinIcon(float x, float y, float s) {
-    glColor3f(0.2f, 0.9f, 0.95f); // Updated to cyan to match new coin color
-    glBegin(GL_POLYGON);
+void drawCoinIconArt(float x, float y, float s) {
+    gfxColor3f(0.2f, 0.9f, 0.95f); // Updated to cyan to match new coin color
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 16; i++) {
         float a = 2.0f * M_PI * i / 16;
-        glVertex2f(x + 5*s * cos(a), y + 5*s * sin(a));
+        gfxVertex2f(x + 5*s * cos(a), y + 5*s * sin(a));
     }
-    glEnd();
-    glColor3f(0.8f, 1.0f, 1.0f); // Lighter cyan for highlight
-    glBegin(GL_LINES);
-    glVertex2f(x - 3*s, y);
-    glVertex2f(x + 3*s, y);
-    glEnd();
+    gfxEnd();
+    gfxColor3f(0.8f, 1.0f, 1.0f); // Lighter cyan for highlight
+    gfxBegin(GL_LINES);
+    gfxVertex2f(x - 3*s, y);
+    gfxVertex2f(x + 3*s, y);
+    gfxEnd();
 }
 
-void drawKeyIcon(float x, float y, float s) {
-    glColor3f(0.95f, 0.75f, 1.0f); // Updated to purple to match new key color
+void drawKeyIconArt(float x, float y, float s) {
+    gfxColor3f(0.95f, 0.75f, 1.0f); // Updated to purple to match new key color
     // Head
-    glBegin(GL_POLYGON);
+    gfxBegin(GL_POLYGON);
     for (int i = 0; i < 12; i++) {
         float a = 2.0f * M_PI * i / 12;
-        glVertex2f(x - 6*s + 4*s * cos(a), y + 4*s * sin(a));
+        gfxVertex2f(x - 6*s + 4*s * cos(a), y + 4*s * sin(a));
     }
-    glEnd();
+    gfxEnd();
     // Shaft
-    glBegin(GL_QUADS);
-    glVertex2f(x - 2*s, y - 1*s);
-    glVertex2f(x + 8*s, y - 1*s);
-    glVertex2f(x + 8*s, y + 1*s);
-    glVertex2f(x - 2*s, y + 1*s);
-    glEnd();
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(x - 2*s, y - 1*s);
+    gfxVertex2f(x + 8*s, y - 1*s);
+    gfxVertex2f(x + 8*s, y + 1*s);
+    gfxVertex2f(x - 2*s, y + 1*s);
+    gfxEnd();
     // Teeth
-    glBegin(GL_TRIANGLES);
-    glVertex2f(x + 8*s, y - 1*s);
-    glVertex2f(x + 11*s, y - 1*s);
-    glVertex2f(x + 11*s, y + 1*s);
-    glEnd();
+    gfxBegin(GL_TRIANGLES);
+    gfxVertex2f(x + 8*s, y - 1*s);
+    gfxVertex2f(x + 11*s, y - 1*s);
+    gfxVertex2f(x + 11*s, y + 1*s);
+    gfxEnd();
+}
+
+// HUD icons: one atlas quad each, or the primitives if there is no atlas
+void drawIconSprite(int sprite, void (*drawArt)(float, float, float), float x, float y, float s) {
+    if (!atlas.texture) {
+        drawArt(x, y, s);
+        return;
+    }
+    gfxBeginPremultiplied(atlas.texture);
+    drawSprite(sprite, x, y, s);
+    gfxEndPremultiplied();
 }
 
+void drawHeartIcon(float x, float y, float s) { drawIconSprite(SPRITE_HEART_ICON, drawHeartIconArt, x, y, s); }
+void drawCoinIcon(float x, float y, float s) { drawIconSprite(SPRITE_COIN_ICON, drawCoinIconArt, x, y, s); }
+void drawKeyIcon(float x, float y, float s) { drawIconSprite(SPRITE_KEY_ICON, drawKeyIconArt, x, y, s); }
+
 // Draw HUD
 void drawHUD() {
+    const RenderSnapshot& frame = renderSnapshots.front();
     // Main compact HUD panel at bottom
     drawBrickPanelWithShadow(5, 5, WIDTH - 10, 60, 0.4f, 0.4f, 0.6f);
     
@@ -1604,60 +4832,60 @@ void drawHUD() {
     drawHeartIcon(45, 50, 0.7f);
     
     // Health bar (compact)
-    glColor3f(0.2f, 0.2f, 0.2f);
-    glBegin(GL_QUADS);
-    glVertex2f(55, 43);
-    glVertex2f(145, 43);
-    glVertex2f(145, 55);
-    glVertex2f(55, 55);
-    glEnd();
-    
-    float healthRatio = (float)playerLives / 3.0f;
-    if (healthRatio > 0.6f) glColor3f(0.2f, 0.8f, 0.2f);
-    else if (healthRatio > 0.3f) glColor3f(0.8f, 0.8f, 0.2f);
-    else glColor3f(0.8f, 0.2f, 0.2f);
+    gfxColor3f(0.2f, 0.2f, 0.2f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(55, 43);
+    gfxVertex2f(145, 43);
+    gfxVertex2f(145, 55);
+    gfxVertex2f(55, 55);
+    gfxEnd();
+    
+    float healthRatio = (float)frame.playerLives / 3.0f;
+    if (healthRatio > 0.6f) gfxColor3f(0.2f, 0.8f, 0.2f);
+    else if (healthRatio > 0.3f) gfxColor3f(0.8f, 0.8f, 0.2f);
+    else gfxColor3f(0.8f, 0.2f, 0.2f);
     
     float healthWidth = 90.0f * healthRatio;
-    glBegin(GL_QUADS);
-    glVertex2f(55, 43);
-    glVertex2f(55 + healthWidth, 43);
-    glVertex2f(55 + healthWidth, 55);
-    glVertex2f(55, 55);
-    glEnd();
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(55, 43);
+    gfxVertex2f(55 + healthWidth, 43);
+    gfxVertex2f(55 + healthWidth, 55);
+    gfxVertex2f(55, 55);
+    gfxEnd();
     
     // Lava danger (compact)
     drawBrickPanelWithShadow(165, 40, 150, 18, 0.5f, 0.3f, 0.3f);
     drawShadowedText(170, 53, "Lava:", 1.0f, 1.0f, 1.0f);
     
-    glColor3f(0.2f, 0.2f, 0.2f);
-    glBegin(GL_QUADS);
-    glVertex2f(210, 43);
-    glVertex2f(305, 43);
-    glVertex2f(305, 55);
-    glVertex2f(210, 55);
-    glEnd();
+    gfxColor3f(0.2f, 0.2f, 0.2f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(210, 43);
+    gfxVertex2f(305, 43);
+    gfxVertex2f(305, 55);
+    gfxVertex2f(210, 55);
+    gfxEnd();
     
-    float dangerLevel = std::min(1.0f, lavaHeight / (HEIGHT * 0.7f));
-    glColor3f(1.0f, 1.0f - dangerLevel, 0.0f);
+    float dangerLevel = std::min(1.0f, frame.lavaHeight / (HEIGHT * 0.7f));
+    gfxColor3f(1.0f, 1.0f - dangerLevel, 0.0f);
     float dangerWidth = 95.0f * dangerLevel;
-    glBegin(GL_QUADS);
-    glVertex2f(210, 43);
-    glVertex2f(210 + dangerWidth, 43);
-    glVertex2f(210 + dangerWidth, 55);
-    glVertex2f(210, 55);
-    glEnd();
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(210, 43);
+    gfxVertex2f(210 + dangerWidth, 43);
+    gfxVertex2f(210 + dangerWidth, 55);
+    gfxVertex2f(210, 55);
+    gfxEnd();
     
     // Center: Coins collected (moved from top)
     int collected = 0;
-    for (const auto& c : collectables) {
+    for (const auto& c : frame.collectables) {
         if (c.collected) collected++;
     }
     
     drawBrickPanelWithShadow(WIDTH / 2 - 90, 40, 180, 18, 0.5f, 0.5f, 0.2f);
-    if (keyCollected) {
+    if (frame.keyCollected) {
         drawShadowedText(WIDTH / 2 - 50, 53, "KEY FOUND!", 0.0f, 1.0f, 0.0f);
         drawKeyIcon(WIDTH / 2 + 40, 50, 0.6f);
-    } else if (keySpawned) {
+    } else if (frame.keySpawned) {
         drawShadowedText(WIDTH / 2 - 55, 53, "KEY AVAILABLE!", 1.0f, 1.0f, 0.0f);
         drawKeyIcon(WIDTH / 2 + 50, 50, 0.6f);
     } else {
@@ -1669,130 +4897,131 @@ void drawHUD() {
     // Right side: Score
     drawBrickPanelWithShadow(WIDTH - 180, 40, 170, 18, 0.6f, 0.5f, 0.3f);
     std::stringstream ss;
-    ss << "Score: " << score;
+    ss << "Score: " << frame.score;
     drawShadowedText(WIDTH - 175, 53, ss.str().c_str(), 1.0f, 1.0f, 1.0f);
     drawCoinIcon(WIDTH - 30, 50, 0.7f);
     
     // Bottom line: Coins counter
     std::stringstream collectText;
-    collectText << "Coins: " << collected << "/" << collectables.size();
+    collectText << "Coins: " << collected << "/" << frame.collectables.size();
     drawShadowedText(15, 20, collectText.str().c_str(), 1.0f, 1.0f, 1.0f);
     drawCoinIcon(100, 18, 0.6f);
     
     // Power-up indicator (bottom right, compact)
-    if (player.powerUpType > 0) {
-        std::string powerUpText = (player.powerUpType == 1) ? "SHIELD" : "DOUBLE JUMP";
+    if (frame.player.powerUpType > 0) {
+        std::string powerUpText = (frame.player.powerUpType == 1) ? "SHIELD" : "DOUBLE JUMP";
         drawShadowedText(WIDTH - 120, 20, powerUpText.c_str(), 0.0f, 1.0f, 0.0f);
         
         // Mini timer bar
-        float timerRatio = player.powerUpTimer / 12.0f;
-        glColor3f(0.2f, 0.2f, 0.2f);
-        glBegin(GL_QUADS);
-        glVertex2f(WIDTH - 120, 10);
-        glVertex2f(WIDTH - 20, 10);
-        glVertex2f(WIDTH - 20, 13);
-        glVertex2f(WIDTH - 120, 13);
-        glEnd();
+        float timerRatio = frame.player.powerUpTimer / 12.0f;
+        gfxColor3f(0.2f, 0.2f, 0.2f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(WIDTH - 120, 10);
+        gfxVertex2f(WIDTH - 20, 10);
+        gfxVertex2f(WIDTH - 20, 13);
+        gfxVertex2f(WIDTH - 120, 13);
+        gfxEnd();
         
-        glColor3f(0.0f, 0.8f, 0.8f);
-        glBegin(GL_QUADS);
-        glVertex2f(WIDTH - 120, 10);
-        glVertex2f(WIDTH - 120 + 100 * timerRatio, 10);
-        glVertex2f(WIDTH - 120 + 100 * timerRatio, 13);
-        glVertex2f(WIDTH - 120, 13);
-        glEnd();
+        gfxColor3f(0.0f, 0.8f, 0.8f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(WIDTH - 120, 10);
+        gfxVertex2f(WIDTH - 120 + 100 * timerRatio, 10);
+        gfxVertex2f(WIDTH - 120 + 100 * timerRatio, 13);
+        gfxVertex2f(WIDTH - 120, 13);
+        gfxEnd();
     }
 }
 
 // Draw game over screen (stylized)
 void drawGameOver() {
+    const RenderSnapshot& frame = renderSnapshots.front();
     float t = menuAnimTime;
     
     // Use the Vice City background but with darker overlay
     drawLayeredBackground();
     
     // Dark red overlay for game over effect
-    glColor4f(0.3f, 0.0f, 0.0f, 0.4f + 0.2f * sin(t * 2.0f));
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WIDTH, 0);
-    glVertex2f(WIDTH, HEIGHT);
-    glVertex2f(0, HEIGHT);
-    glEnd();
+    gfxColor4f(0.3f, 0.0f, 0.0f, 0.4f + 0.2f * sin(t * 2.0f));
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(0, 0);
+    gfxVertex2f(WIDTH, 0);
+    gfxVertex2f(WIDTH, HEIGHT);
+    gfxVertex2f(0, HEIGHT);
+    gfxEnd();
 
     // Big GAME OVER logo with dramatic effect
     float logoScale = 0.8f + 0.1f * sin(t * 2.0f);
     float jitterX = sin(t * 8.0f) * 3.0f;
     float jitterY = cos(t * 6.0f) * 2.0f;
     
-    glPushMatrix();
-    glTranslatef(WIDTH / 2.0f + jitterX, HEIGHT / 2 + 150 + jitterY, 0);
-    glScalef(logoScale, logoScale, 1.0f);
+    gfxPushMatrix();
+    gfxTranslatef(WIDTH / 2.0f + jitterX, HEIGHT / 2 + 150 + jitterY, 0);
+    gfxScalef(logoScale, logoScale, 1.0f);
     
     // GAME text
-    glColor3f(1.0f, 0.2f + 0.3f * sin(t * 3.0f), 0.0f);
-    glBegin(GL_QUADS);
+    gfxColor3f(1.0f, 0.2f + 0.3f * sin(t * 3.0f), 0.0f);
+    gfxBegin(GL_QUADS);
     // G
-    glVertex2f(-120, 40); glVertex2f(-80, 40); glVertex2f(-80, 30); glVertex2f(-120, 30);
-    glVertex2f(-120, 30); glVertex2f(-110, 30); glVertex2f(-110, -20); glVertex2f(-120, -20);
-    glVertex2f(-120, -20); glVertex2f(-80, -20); glVertex2f(-80, -30); glVertex2f(-120, -30);
-    glVertex2f(-90, 0); glVertex2f(-80, 0); glVertex2f(-80, -20); glVertex2f(-90, -20);
-    glVertex2f(-100, -10); glVertex2f(-80, -10); glVertex2f(-80, -20); glVertex2f(-100, -20);
+    gfxVertex2f(-120, 40); gfxVertex2f(-80, 40); gfxVertex2f(-80, 30); gfxVertex2f(-120, 30);
+    gfxVertex2f(-120, 30); gfxVertex2f(-110, 30); gfxVertex2f(-110, -20); gfxVertex2f(-120, -20);
+    gfxVertex2f(-120, -20); gfxVertex2f(-80, -20); gfxVertex2f(-80, -30); gfxVertex2f(-120, -30);
+    gfxVertex2f(-90, 0); gfxVertex2f(-80, 0); gfxVertex2f(-80, -20); gfxVertex2f(-90, -20);
+    gfxVertex2f(-100, -10); gfxVertex2f(-80, -10); gfxVertex2f(-80, -20); gfxVertex2f(-100, -20);
     
     // A
-    glVertex2f(-70, -30); glVertex2f(-60, -30); glVertex2f(-45, 40); glVertex2f(-55, 40);
-    glVertex2f(-45, 40); glVertex2f(-35, 40); glVertex2f(-20, -30); glVertex2f(-30, -30);
-    glVertex2f(-55, 10); glVertex2f(-35, 10); glVertex2f(-35, 0); glVertex2f(-55, 0);
+    gfxVertex2f(-70, -30); gfxVertex2f(-60, -30); gfxVertex2f(-45, 40); gfxVertex2f(-55, 40);
+    gfxVertex2f(-45, 40); gfxVertex2f(-35, 40); gfxVertex2f(-20, -30); gfxVertex2f(-30, -30);
+    gfxVertex2f(-55, 10); gfxVertex2f(-35, 10); gfxVertex2f(-35, 0); gfxVertex2f(-55, 0);
     
     // M
-    glVertex2f(-10, 40); glVertex2f(0, 40); glVertex2f(0, -30); glVertex2f(-10, -30);
-    glVertex2f(20, 40); glVertex2f(30, 40); glVertex2f(30, -30); glVertex2f(20, -30);
-    glVertex2f(0, 30); glVertex2f(10, 40); glVertex2f(20, 30); glVertex2f(10, 20);
+    gfxVertex2f(-10, 40); gfxVertex2f(0, 40); gfxVertex2f(0, -30); gfxVertex2f(-10, -30);
+    gfxVertex2f(20, 40); gfxVertex2f(30, 40); gfxVertex2f(30, -30); gfxVertex2f(20, -30);
+    gfxVertex2f(0, 30); gfxVertex2f(10, 40); gfxVertex2f(20, 30); gfxVertex2f(10, 20);
     
     // E
-    glVertex2f(40, 40); glVertex2f(80, 40); glVertex2f(80, 30); glVertex2f(40, 30);
-    glVertex2f(40, 30); glVertex2f(50, 30); glVertex2f(50, 10); glVertex2f(40, 10);
-    glVertex2f(40, 10); glVertex2f(70, 10); glVertex2f(70, 0); glVertex2f(40, 0);
-    glVertex2f(40, 0); glVertex2f(50, 0); glVertex2f(50, -20); glVertex2f(40, -20);
-    glVertex2f(40, -20); glVertex2f(80, -20); glVertex2f(80, -30); glVertex2f(40, -30);
-    glEnd();
+    gfxVertex2f(40, 40); gfxVertex2f(80, 40); gfxVertex2f(80, 30); gfxVertex2f(40, 30);
+    gfxVertex2f(40, 30); gfxVertex2f(50, 30); gfxVertex2f(50, 10); gfxVertex2f(40, 10);
+    gfxVertex2f(40, 10); gfxVertex2f(70, 10); gfxVertex2f(70, 0); gfxVertex2f(40, 0);
+    gfxVertex2f(40, 0); gfxVertex2f(50, 0); gfxVertex2f(50, -20); gfxVertex2f(40, -20);
+    gfxVertex2f(40, -20); gfxVertex2f(80, -20); gfxVertex2f(80, -30); gfxVertex2f(40, -30);
+    gfxEnd();
     
-    glPopMatrix();
+    gfxPopMatrix();
     
     // OVER text
-    glPushMatrix();
-    glTranslatef(WIDTH / 2.0f + jitterX, HEIGHT / 2 + 80 + jitterY, 0);
-    glScalef(logoScale * 0.8f, logoScale * 0.8f, 1.0f);
+    gfxPushMatrix();
+    gfxTranslatef(WIDTH / 2.0f + jitterX, HEIGHT / 2 + 80 + jitterY, 0);
+    gfxScalef(logoScale * 0.8f, logoScale * 0.8f, 1.0f);
     
-    glColor3f(0.8f, 0.0f, 0.0f);
-    glBegin(GL_QUADS);
+    gfxColor3f(0.8f, 0.0f, 0.0f);
+    gfxBegin(GL_QUADS);
     // O
-    glVertex2f(-80, 30); glVertex2f(-40, 30); glVertex2f(-40, 20); glVertex2f(-80, 20);
-    glVertex2f(-80, 20); glVertex2f(-70, 20); glVertex2f(-70, -20); glVertex2f(-80, -20);
-    glVertex2f(-50, 20); glVertex2f(-40, 20); glVertex2f(-40, -20); glVertex2f(-50, -20);
-    glVertex2f(-80, -20); glVertex2f(-40, -20); glVertex2f(-40, -30); glVertex2f(-80, -30);
+    gfxVertex2f(-80, 30); gfxVertex2f(-40, 30); gfxVertex2f(-40, 20); gfxVertex2f(-80, 20);
+    gfxVertex2f(-80, 20); gfxVertex2f(-70, 20); gfxVertex2f(-70, -20); gfxVertex2f(-80, -20);
+    gfxVertex2f(-50, 20); gfxVertex2f(-40, 20); gfxVertex2f(-40, -20); gfxVertex2f(-50, -20);
+    gfxVertex2f(-80, -20); gfxVertex2f(-40, -20); gfxVertex2f(-40, -30); gfxVertex2f(-80, -30);
     
     // V
-    glVertex2f(-30, 30); glVertex2f(-20, 30); glVertex2f(-5, -30); glVertex2f(-15, -30);
-    glVertex2f(5, 30); glVertex2f(15, 30); glVertex2f(0, -30); glVertex2f(-10, -30);
+    gfxVertex2f(-30, 30); gfxVertex2f(-20, 30); gfxVertex2f(-5, -30); gfxVertex2f(-15, -30);
+    gfxVertex2f(5, 30); gfxVertex2f(15, 30); gfxVertex2f(0, -30); gfxVertex2f(-10, -30);
     
     // E
-    glVertex2f(25, 30); glVertex2f(65, 30); glVertex2f(65, 20); glVertex2f(25, 20);
-    glVertex2f(25, 20); glVertex2f(35, 20); glVertex2f(35, 5); glVertex2f(25, 5);
-    glVertex2f(25, 5); glVertex2f(55, 5); glVertex2f(55, -5); glVertex2f(25, -5);
-    glVertex2f(25, -5); glVertex2f(35, -5); glVertex2f(35, -20); glVertex2f(25, -20);
-    glVertex2f(25, -20); glVertex2f(65, -20); glVertex2f(65, -30); glVertex2f(25, -30);
+    gfxVertex2f(25, 30); gfxVertex2f(65, 30); gfxVertex2f(65, 20); gfxVertex2f(25, 20);
+    gfxVertex2f(25, 20); gfxVertex2f(35, 20); gfxVertex2f(35, 5); gfxVertex2f(25, 5);
+    gfxVertex2f(25, 5); gfxVertex2f(55, 5); gfxVertex2f(55, -5); gfxVertex2f(25, -5);
+    gfxVertex2f(25, -5); gfxVertex2f(35, -5); gfxVertex2f(35, -20); gfxVertex2f(25, -20);
+    gfxVertex2f(25, -20); gfxVertex2f(65, -20); gfxVertex2f(65, -30); gfxVertex2f(25, -30);
     
     // R
-    glVertex2f(75, 30); glVertex2f(115, 30); glVertex2f(115, 20); glVertex2f(75, 20);
-    glVertex2f(75, 20); glVertex2f(85, 20); glVertex2f(85, 5); glVertex2f(75, 5);
-    glVertex2f(75, 5); glVertex2f(105, 5); glVertex2f(105, -5); glVertex2f(75, -5);
-    glVertex2f(95, 5); glVertex2f(105, 5); glVertex2f(115, -30); glVertex2f(105, -30);
-    glVertex2f(75, -5); glVertex2f(85, -5); glVertex2f(85, -30); glVertex2f(75, -30);
-    glVertex2f(105, 20); glVertex2f(115, 20); glVertex2f(115, 5); glVertex2f(105, 5);
-    glEnd();
-    
-    glPopMatrix();
+    gfxVertex2f(75, 30); gfxVertex2f(115, 30); gfxVertex2f(115, 20); gfxVertex2f(75, 20);
+    gfxVertex2f(75, 20); gfxVertex2f(85, 20); gfxVertex2f(85, 5); gfxVertex2f(75, 5);
+    gfxVertex2f(75, 5); gfxVertex2f(105, 5); gfxVertex2f(105, -5); gfxVertex2f(75, -5);
+    gfxVertex2f(95, 5); gfxVertex2f(105, 5); gfxVertex2f(115, -30); gfxVertex2f(105, -30);
+    gfxVertex2f(75, -5); gfxVertex2f(85, -5); gfxVertex2f(85, -30); gfxVertex2f(75, -30);
+    gfxVertex2f(105, 20); gfxVertex2f(115, 20); gfxVertex2f(115, 5); gfxVertex2f(105, 5);
+    gfxEnd();
+    
+    gfxPopMatrix();
 
     // Interactive buttons (same as win screen)
     float buttonY = HEIGHT / 2 - 50;
@@ -1806,13 +5035,13 @@ void drawGameOver() {
         if (selected) {
             // Selected button - red glowing effect for game over
             drawBrickPanelWithShadow(buttonX, y, buttonWidth, buttonHeight, 0.8f, 0.2f, 0.2f, 0.5f);
-            glColor4f(1.0f, 0.0f, 0.0f, 0.3f + 0.2f * sin(t * 5.0f));
-            glBegin(GL_QUADS);
-            glVertex2f(buttonX - 5, y - 5);
-            glVertex2f(buttonX + buttonWidth + 5, y - 5);
-            glVertex2f(buttonX + buttonWidth + 5, y + buttonHeight + 5);
-            glVertex2f(buttonX - 5, y + buttonHeight + 5);
-            glEnd();
+            gfxColor4f(1.0f, 0.0f, 0.0f, 0.3f + 0.2f * sin(t * 5.0f));
+            gfxBegin(GL_QUADS);
+            gfxVertex2f(buttonX - 5, y - 5);
+            gfxVertex2f(buttonX + buttonWidth + 5, y - 5);
+            gfxVertex2f(buttonX + buttonWidth + 5, y + buttonHeight + 5);
+            gfxVertex2f(buttonX - 5, y + buttonHeight + 5);
+            gfxEnd();
             drawShadowedTextCentered(WIDTH / 2.0f, y + 30, label, 1.0f, 1.0f, 0.0f);
         } else {
             drawBrickPanelWithShadow(buttonX, y, buttonWidth, buttonHeight, 0.3f, 0.3f, 0.3f);
@@ -1825,12 +5054,12 @@ void drawGameOver() {
     
     // Stats in smaller panel at the bottom
     std::stringstream ss;
-    ss << "Score: " << score << " | ";
+    ss << "Score: " << frame.score << " | ";
     
     int collected = 0;
-    for (const auto& c : collectables) if (c.collected) collected++;
-    ss << "Coins: " << collected << "/" << collectables.size() << " | ";
-    ss << "Time: " << (int)gameTime << "s";
+    for (const auto& c : frame.collectables) if (c.collected) collected++;
+    ss << "Coins: " << collected << "/" << frame.collectables.size() << " | ";
+    ss << "Time: " << (int)frame.gameTime << "s";
     
     float statsWidth = measureTextWidth(ss.str().c_str()) + 40;
     drawBrickPanelWithShadow(WIDTH / 2 - statsWidth/2, 50, statsWidth, 32, 0.3f, 0.2f, 0.2f, 0.4f);
@@ -1839,47 +5068,25 @@ void drawGameOver() {
 
 // Draw game win screen (stylized)
 void drawGameWin() {
+    const RenderSnapshot& frame = renderSnapshots.front();
     float t = menuAnimTime;
     
     // Use the same Vice City background as other screens
     drawLayeredBackground();
     
-    // Update and draw falling characters
-    characterSpawnTimer += 0.016f;
-    if (characterSpawnTimer > 0.3f && fallingCharacters.size() < 15) {
-        FallingCharacter newChar;
-        newChar.x = rand() % WIDTH;
-        newChar.y = HEIGHT + 50;
-        newChar.type = (CharacterType)(rand() % 3); // Random character type
-        newChar.rotationSpeed = (rand() % 60) + 30; // 30-90 degrees per second
-        newChar.rotation = 0;
-        newChar.fallSpeed = (rand() % 100) + 150; // 150-250 pixels per second
-        newChar.scale = 0.5f + (rand() % 50) / 100.0f; // 0.5 to 1.0 scale
-        newChar.active = true;
-        fallingCharacters.push_back(newChar);
-        characterSpawnTimer = 0.0f;
-    }
-    
-    // Update falling characters
-    for (auto& character : fallingCharacters) {
+    // Draw falling characters
+    for (const auto& character : fallingCharacters) {
         if (!character.active) continue;
         
-        character.y -= character.fallSpeed * 0.016f;
-        character.rotation += character.rotationSpeed * 0.016f;
-        
-        if (character.y < -100) {
-            character.active = false;
-        }
-        
         // Draw the falling character
-        glPushMatrix();
-        glTranslatef(character.x, character.y, 0);
-        glRotatef(character.rotation, 0, 0, 1);
-        glScalef(character.scale, character.scale, 1.0f);
+        gfxPushMatrix();
+        gfxTranslatef(character.x, character.y, 0);
+        gfxRotatef(character.rotation, 0, 0, 1);
+        gfxScalef(character.scale, character.scale, 1.0f);
         
         // Add transparency
         glEnable(GL_BLEND);
-        glColor4f(1.0f, 1.0f, 1.0f, 0.7f);
+        gfxColor4f(1.0f, 1.0f, 1.0f, 0.7f);
         
         switch (character.type) {
             case WITCH:
@@ -1893,23 +5100,17 @@ void drawGameWin() {
                 break;
         }
         
-        glPopMatrix();
+        gfxPopMatrix();
     }
     
-    // Remove inactive characters
-    fallingCharacters.erase(
-        std::remove_if(fallingCharacters.begin(), fallingCharacters.end(),
-                      [](const FallingCharacter& c) { return !c.active; }),
-        fallingCharacters.end());
-    
     // Victory celebration background effect
-    glColor4f(1.0f, 1.0f, 0.0f, 0.1f + 0.1f * sin(t * 3.0f));
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WIDTH, 0);
-    glVertex2f(WIDTH, HEIGHT);
-    glVertex2f(0, HEIGHT);
-    glEnd();
+    gfxColor4f(1.0f, 1.0f, 0.0f, 0.1f + 0.1f * sin(t * 3.0f));
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(0, 0);
+    gfxVertex2f(WIDTH, 0);
+    gfxVertex2f(WIDTH, HEIGHT);
+    gfxVertex2f(0, HEIGHT);
+    gfxEnd();
 
     // Celebration sparkles around the screen edges
     for (int i = 0; i < 20; i++) {
@@ -1919,75 +5120,75 @@ void drawGameWin() {
         float sparkleY = HEIGHT / 2 + radius * sin(angle);
         
         float sparkleSize = 3 + 2 * sin(t * 5.0f + i);
-        glColor4f(1.0f, 1.0f, 0.0f, 0.8f);
-        glBegin(GL_QUADS);
-        glVertex2f(sparkleX - sparkleSize, sparkleY - sparkleSize);
-        glVertex2f(sparkleX + sparkleSize, sparkleY - sparkleSize);
-        glVertex2f(sparkleX + sparkleSize, sparkleY + sparkleSize);
-        glVertex2f(sparkleX - sparkleSize, sparkleY + sparkleSize);
-        glEnd();
+        gfxColor4f(1.0f, 1.0f, 0.0f, 0.8f);
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(sparkleX - sparkleSize, sparkleY - sparkleSize);
+        gfxVertex2f(sparkleX + sparkleSize, sparkleY - sparkleSize);
+        gfxVertex2f(sparkleX + sparkleSize, sparkleY + sparkleSize);
+        gfxVertex2f(sparkleX - sparkleSize, sparkleY + sparkleSize);
+        gfxEnd();
     }
 
     // Big YOU WIN logo - simpler and cleaner
     float logoScale = 1.0f + 0.1f * sin(t * 2.0f);
     
     // YOU text
-    glPushMatrix();
-    glTranslatef(WIDTH / 2.0f, HEIGHT / 2 + 150, 0);
-    glScalef(logoScale, logoScale, 1.0f);
+    gfxPushMatrix();
+    gfxTranslatef(WIDTH / 2.0f, HEIGHT / 2 + 150, 0);
+    gfxScalef(logoScale, logoScale, 1.0f);
     
-    glColor3f(1.0f, 0.8f + 0.2f * sin(t * 3.0f), 0.0f);
+    gfxColor3f(1.0f, 0.8f + 0.2f * sin(t * 3.0f), 0.0f);
     
     // Draw "YOU" using text-like rectangles
     // Y
-    glBegin(GL_QUADS);
-    glVertex2f(-80, 40); glVertex2f(-70, 40); glVertex2f(-55, 10); glVertex2f(-65, 10);
-    glVertex2f(-45, 40); glVertex2f(-35, 40); glVertex2f(-50, 10); glVertex2f(-60, 10);
-    glVertex2f(-62, 10); glVertex2f(-53, 10); glVertex2f(-53, -40); glVertex2f(-62, -40);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(-80, 40); gfxVertex2f(-70, 40); gfxVertex2f(-55, 10); gfxVertex2f(-65, 10);
+    gfxVertex2f(-45, 40); gfxVertex2f(-35, 40); gfxVertex2f(-50, 10); gfxVertex2f(-60, 10);
+    gfxVertex2f(-62, 10); gfxVertex2f(-53, 10); gfxVertex2f(-53, -40); gfxVertex2f(-62, -40);
     
     // O
-    glVertex2f(-25, 40); glVertex2f(5, 40); glVertex2f(5, 30); glVertex2f(-25, 30);
-    glVertex2f(-25, 30); glVertex2f(-15, 30); glVertex2f(-15, -30); glVertex2f(-25, -30);
-    glVertex2f(-5, 30); glVertex2f(5, 30); glVertex2f(5, -30); glVertex2f(-5, -30);
-    glVertex2f(-25, -30); glVertex2f(5, -30); glVertex2f(5, -40); glVertex2f(-25, -40);
+    gfxVertex2f(-25, 40); gfxVertex2f(5, 40); gfxVertex2f(5, 30); gfxVertex2f(-25, 30);
+    gfxVertex2f(-25, 30); gfxVertex2f(-15, 30); gfxVertex2f(-15, -30); gfxVertex2f(-25, -30);
+    gfxVertex2f(-5, 30); gfxVertex2f(5, 30); gfxVertex2f(5, -30); gfxVertex2f(-5, -30);
+    gfxVertex2f(-25, -30); gfxVertex2f(5, -30); gfxVertex2f(5, -40); gfxVertex2f(-25, -40);
     
     // U
-    glVertex2f(15, 40); glVertex2f(25, 40); glVertex2f(25, -30); glVertex2f(15, -30);
-    glVertex2f(45, 40); glVertex2f(55, 40); glVertex2f(55, -30); glVertex2f(45, -30);
-    glVertex2f(15, -30); glVertex2f(55, -30); glVertex2f(55, -40); glVertex2f(15, -40);
-    glEnd();
+    gfxVertex2f(15, 40); gfxVertex2f(25, 40); gfxVertex2f(25, -30); gfxVertex2f(15, -30);
+    gfxVertex2f(45, 40); gfxVertex2f(55, 40); gfxVertex2f(55, -30); gfxVertex2f(45, -30);
+    gfxVertex2f(15, -30); gfxVertex2f(55, -30); gfxVertex2f(55, -40); gfxVertex2f(15, -40);
+    gfxEnd();
     
-    glPopMatrix();
+    gfxPopMatrix();
     
     // WIN text
-    glPushMatrix();
-    glTranslatef(WIDTH / 2.0f, HEIGHT / 2 + 60, 0);
-    glScalef(logoScale, logoScale, 1.0f);
+    gfxPushMatrix();
+    gfxTranslatef(WIDTH / 2.0f, HEIGHT / 2 + 60, 0);
+    gfxScalef(logoScale, logoScale, 1.0f);
     
-    glColor3f(0.0f, 1.0f, 0.5f + 0.5f * sin(t * 4.0f));
+    gfxColor3f(0.0f, 1.0f, 0.5f + 0.5f * sin(t * 4.0f));
     
     // Draw "WIN"
-    glBegin(GL_QUADS);
+    gfxBegin(GL_QUADS);
     // W
-    glVertex2f(-90, 40); glVertex2f(-80, 40); glVertex2f(-80, -40); glVertex2f(-90, -40);
-    glVertex2f(-55, 40); glVertex2f(-45, 40); glVertex2f(-45, -40); glVertex2f(-55, -40);
-    glVertex2f(-80, -20); glVertex2f(-72, -20); glVertex2f(-65, -40); glVertex2f(-73, -40);
-    glVertex2f(-72, -20); glVertex2f(-62, -20); glVertex2f(-55, -40); glVertex2f(-63, -40);
+    gfxVertex2f(-90, 40); gfxVertex2f(-80, 40); gfxVertex2f(-80, -40); gfxVertex2f(-90, -40);
+    gfxVertex2f(-55, 40); gfxVertex2f(-45, 40); gfxVertex2f(-45, -40); gfxVertex2f(-55, -40);
+    gfxVertex2f(-80, -20); gfxVertex2f(-72, -20); gfxVertex2f(-65, -40); gfxVertex2f(-73, -40);
+    gfxVertex2f(-72, -20); gfxVertex2f(-62, -20); gfxVertex2f(-55, -40); gfxVertex2f(-63, -40);
     
     // I
-    glVertex2f(-30, 40); glVertex2f(0, 40); glVertex2f(0, 30); glVertex2f(-30, 30);
-    glVertex2f(-20, 30); glVertex2f(-10, 30); glVertex2f(-10, -30); glVertex2f(-20, -30);
-    glVertex2f(-30, -30); glVertex2f(0, -30); glVertex2f(0, -40); glVertex2f(-30, -40);
+    gfxVertex2f(-30, 40); gfxVertex2f(0, 40); gfxVertex2f(0, 30); gfxVertex2f(-30, 30);
+    gfxVertex2f(-20, 30); gfxVertex2f(-10, 30); gfxVertex2f(-10, -30); gfxVertex2f(-20, -30);
+    gfxVertex2f(-30, -30); gfxVertex2f(0, -30); gfxVertex2f(0, -40); gfxVertex2f(-30, -40);
     
     // N
-    glVertex2f(15, 40); glVertex2f(25, 40); glVertex2f(25, -40); glVertex2f(15, -40);
-    glVertex2f(55, 40); glVertex2f(65, 40); glVertex2f(65, -40); glVertex2f(55, -40);
-    glVertex2f(25, 30); glVertex2f(35, 40); glVertex2f(45, 30); glVertex2f(35, 20);
-    glVertex2f(25, 10); glVertex2f(35, 20); glVertex2f(45, 10); glVertex2f(35, 0);
-    glVertex2f(25, -10); glVertex2f(35, 0); glVertex2f(45, -10); glVertex2f(35, -20);
-    glEnd();
-    
-    glPopMatrix();
+    gfxVertex2f(15, 40); gfxVertex2f(25, 40); gfxVertex2f(25, -40); gfxVertex2f(15, -40);
+    gfxVertex2f(55, 40); gfxVertex2f(65, 40); gfxVertex2f(65, -40); gfxVertex2f(55, -40);
+    gfxVertex2f(25, 30); gfxVertex2f(35, 40); gfxVertex2f(45, 30); gfxVertex2f(35, 20);
+    gfxVertex2f(25, 10); gfxVertex2f(35, 20); gfxVertex2f(45, 10); gfxVertex2f(35, 0);
+    gfxVertex2f(25, -10); gfxVertex2f(35, 0); gfxVertex2f(45, -10); gfxVertex2f(35, -20);
+    gfxEnd();
+    
+    gfxPopMatrix();
 
     // Interactive buttons
     float buttonY = HEIGHT / 2 - 50;
@@ -2001,13 +5202,13 @@ void drawGameWin() {
         if (selected) {
             // Selected button - glowing effect
             drawBrickPanelWithShadow(buttonX, y, buttonWidth, buttonHeight, 0.2f, 0.8f, 0.2f, 0.5f);
-            glColor4f(0.0f, 1.0f, 0.0f, 0.3f + 0.2f * sin(t * 5.0f));
-            glBegin(GL_QUADS);
-            glVertex2f(buttonX - 5, y - 5);
-            glVertex2f(buttonX + buttonWidth + 5, y - 5);
-            glVertex2f(buttonX + buttonWidth + 5, y + buttonHeight + 5);
-            glVertex2f(buttonX - 5, y + buttonHeight + 5);
-            glEnd();
+            gfxColor4f(0.0f, 1.0f, 0.0f, 0.3f + 0.2f * sin(t * 5.0f));
+            gfxBegin(GL_QUADS);
+            gfxVertex2f(buttonX - 5, y - 5);
+            gfxVertex2f(buttonX + buttonWidth + 5, y - 5);
+            gfxVertex2f(buttonX + buttonWidth + 5, y + buttonHeight + 5);
+            gfxVertex2f(buttonX - 5, y + buttonHeight + 5);
+            gfxEnd();
             drawShadowedTextCentered(WIDTH / 2.0f, y + 30, label, 1.0f, 1.0f, 0.0f);
         } else {
             drawBrickPanelWithShadow(buttonX, y, buttonWidth, buttonHeight, 0.5f, 0.5f, 0.5f);
@@ -2020,18 +5221,69 @@ void drawGameWin() {
     
     // Stats in smaller panels at the bottom
     std::stringstream ss;
-    ss << "Score: " << score << " | ";
+    ss << "Score: " << frame.score << " | ";
     
     int collected = 0;
-    for (const auto& c : collectables) if (c.collected) collected++;
-    ss << "Coins: " << collected << "/" << collectables.size() << " | ";
-    ss << "Time: " << (int)gameTime << "s";
+    for (const auto& c : frame.collectables) if (c.collected) collected++;
+    ss << "Coins: " << collected << "/" << frame.collectables.size() << " | ";
+    ss << "Time: " << (int)frame.gameTime << "s";
     
     float statsWidth = measureTextWidth(ss.str().c_str()) + 40;
     drawBrickPanelWithShadow(WIDTH / 2 - statsWidth/2, 50, statsWidth, 32, 0.3f, 0.3f, 0.4f, 0.3f);
     drawShadowedTextCentered(WIDTH / 2.0f, 70, ss.str().c_str(), 0.9f, 0.9f, 0.9f);
 }
 
+// Key collected: the door's 2 s unlock animation
+Sequence doorUnlockSequence() {
+    doorIsUnlocking = true;
+    doorUnlockAnimTime = 0.0f;
+    while (doorUnlockAnimTime < 2.0f) {
+        doorUnlockAnimTime += co_await sequences.nextTick();
+    }
+    doorIsUnlocking = false; // Unlock animation complete
+}
+
+// Player touched the unlocked door: pull them in, then win
+Sequence doorSuctionSequence(float doorX, float doorY) {
+    playerBeingSucked = true;
+    float startX = player.x;
+    float startY = player.y;
+    doorCenterX = doorX + 40; // Center of door
+    doorCenterY = doorY + 60;
+    const float continueDuration = 0.3f;
+    const float suctionDuration = 2.5f;
+    
+    // Phase 1 (0-0.3s): Continue moving briefly in current direction
+    float elapsed = 0.0f;
+    while (true) {
+        float deltaTime = co_await sequences.nextTick();
+        elapsed += deltaTime;
+        if (elapsed >= continueDuration) break;
+        float continueProgress = elapsed / continueDuration;
+        player.x += player.velocityX * deltaTime * (1.0f - continueProgress);
+        player.y += player.velocityY * deltaTime * (1.0f - continueProgress);
+    }
+    
+    // Phase 2 (0.3-2.5s): Stop, rotate with increasing speed, move toward door
+    while (elapsed < suctionDuration) {
+        float suctionProgress = (elapsed - continueDuration) / (suctionDuration - continueDuration);
+        // Ease in cubic for smooth acceleration
+        float easeProgress = suctionProgress * suctionProgress * suctionProgress;
+        
+        player.x = startX + (doorCenterX - startX) * easeProgress;
+        player.y = startY + (doorCenterY - startY) * easeProgress;
+        
+        // Rotation with increasing speed (starts slow, gets faster)
+        float rotationSpeed = suctionProgress * suctionProgress * 1440.0f; // Accelerating rotation
+        playerFlipAngle = -suctionProgress * rotationSpeed;
+        elapsed += co_await sequences.nextTick();
+    }
+    
+    gameState = GAME_WIN;
+    queueSound("you-win-sequence-1-183948.mp3");
+    queueEffect(EFFECT_WIN_SCREEN, 0.0f, 0.0f); // Falling characters for the win screen
+}
+
 // Update game logic
 void update(float deltaTime) {
     if (gameState != PLAYING) return;
@@ -2039,8 +5291,8 @@ void update(float deltaTime) {
     gameTime += deltaTime;
     
     // Update lava - slightly faster for more challenge
-    lavaSpeed = 0.35f + gameTime * 0.008f; // Slightly faster increase
-    lavaHeight += lavaSpeed * deltaTime * 9; // Slightly faster rising
+    lavaSpeed = LAVA_BASE_SPEED + gameTime * LAVA_SPEED_GROWTH;
+    lavaHeight += lavaRise(gameTime, deltaTime);
     
     // Remove platforms touched by lava
     for (auto& platform : platforms) {
@@ -2049,55 +5301,16 @@ void update(float deltaTime) {
         }
     }
     
-    // Skip normal physics if player is being sucked into door
-    if (!playerBeingSucked) {
-        // Update player physics - balanced for challenge
-        player.velocityY -= 750.0f * deltaTime; // Slightly more gravity
-
-        // Smooth continuous movement with acceleration
-        float acceleration = 1200.0f; // Acceleration rate
-        float maxSpeed = 280.0f; // Maximum horizontal speed
-        float deceleration = player.onGround ? 0.80f : 0.92f; // Different deceleration on ground vs air
-        
-        // Apply movement based on key states
-        if (leftPressed) {
-            player.velocityX -= acceleration * deltaTime;
-            if (player.velocityX < -maxSpeed) player.velocityX = -maxSpeed;
-        } else if (rightPressed) {
-            player.velocityX += acceleration * deltaTime;
-            if (player.velocityX > maxSpeed) player.velocityX = maxSpeed;
-        } else {
-            // Decelerate when no keys pressed
-            player.velocityX *= deceleration;
-            // Stop tiny velocities to avoid jitter
-            if (fabs(player.velocityX) < 5.0f) player.velocityX = 0.0f;
-        }
-
-        player.x += player.velocityX * deltaTime;
-        player.y += player.velocityY * deltaTime;
-    }
+    // Where this frame's move starts, for swept collisions
+    float startX = player.x, startY = player.y;
     
-    // Skip boundary checking and collisions during suction
+    // Skip normal physics and collisions if player is being sucked into door
     if (!playerBeingSucked) {
-        // Boundary checking
-        if (player.x < 0) player.x = 0;
-        if (player.x + player.width > WIDTH) player.x = WIDTH - player.width;
-        
-        // Platform collision
-        player.onGround = false;
-        for (const auto& platform : platforms) {
-            if (!platform.active) continue;
-            
-            if (checkCollision(player.x, player.y, player.width, player.height,
-                             platform.x, platform.y, platform.width, platform.height)) {
-                if (player.velocityY <= 0 && player.y > platform.y) {
-                    player.y = platform.y + platform.height;
-                    player.velocityY = 0;
-                    player.onGround = true;
-                    player.hasDoubleJumped = false;
-                }
-            }
-        }
+        int direction = leftPressed ? -1 : rightPressed ? 1 : 0;
+        int landing = stepPlayerMotion(player.x, player.y, player.velocityX, player.velocityY, direction,
+                                       player.onGround, platforms, deltaTime);
+        player.onGround = landing >= 0;
+        if (player.onGround) player.hasDoubleJumped = false;
     }
 
     // Update jump flip timing
@@ -2114,7 +5327,7 @@ void update(float deltaTime) {
     // Lava collision
     if (player.y <= lavaHeight) {
         gameState = GAME_OVER;
-        playSound("game-over-417465.mp3");
+        queueSound("game-over-417465.mp3");
         return;
     }
     
@@ -2128,33 +5341,41 @@ void update(float deltaTime) {
     }
     
     // Spawn rocks - more frequently at random intervals
+    // The overshoot carries over, so the spawn rate doesn't depend on the frame rate
     rockSpawnTimer -= deltaTime;
-    if (rockSpawnTimer <= 0) {
-        rocks.push_back({(float)(rand() % (WIDTH - 20)), (float)HEIGHT, true});
-        rockSpawnTimer = 0.8f + (rand() % 80) / 100.0f; // 0.8s - 1.6s (more frequent)
+    while (rockSpawnTimer <= 0) {
+        rocks.push_back({(float)(rand() % (WIDTH - (int)ROCK_SIZE)), (float)HEIGHT, true});
+        rockSpawnTimer += rockSpawnInterval(rand() % 80);
     }
     
     // Update rocks
     for (auto& rock : rocks) {
         if (!rock.active) continue;
         
-        rock.y -= 200.0f * deltaTime;
+        // Rock collision with player over this frame's moves
+        bool hit = rockHitsPlayer(startX, startY, player.x, player.y, rock.x, rock.y, deltaTime);
+        rock.y -= ROCK_FALL_SPEED * deltaTime;
         
-        // Rock collision with player
-        if (checkCollision(player.x, player.y, player.width, player.height,
-                         rock.x - 10, rock.y - 10, 20, 20)) {
+        if (hit) {
             if (player.powerUpType != 1) { // No shield
                 playerLives--;
                 if (playerLives <= 0) {
                     gameState = GAME_OVER;
-                    playSound("game-over-417465.mp3");
+                    queueSound("game-over-417465.mp3");
                     return;
                 }
             }
+            queueEffect(EFFECT_ROCK_DEBRIS, rock.x, rock.y);
             rock.active = false;
+            continue;
         }
         
-        if (rock.y < -20) {
+        // Splash of debris as a rock falls past the lava surface (cosmetic only)
+        if (rock.y <= lavaHeight && rock.y + ROCK_FALL_SPEED * deltaTime > lavaHeight) {
+            queueEffect(EFFECT_ROCK_DEBRIS, rock.x, lavaHeight);
+        }
+        
+        if (rock.y < ROCK_GONE_Y) {
             rock.active = false;
         }
     }
@@ -2172,10 +5393,10 @@ void update(float deltaTime) {
     for (auto& collectable : collectables) {
         if (collectable.collected) continue;
         
-        if (checkCollision(player.x, player.y, player.width, player.height,
-                         collectable.x - 10, collectable.y - 10, 20, 20)) {
+        if (playerTouchesCoin(player.x, player.y, collectable)) {
             collectable.collected = true;
             score += 100;
+            queueEffect(EFFECT_COIN_SPARKLES, collectable.x, collectable.y);
         }
     }
     
@@ -2189,8 +5410,8 @@ void update(float deltaTime) {
         if (collectedCount >= 5) {
             keySpawned = true;
             // Spawn key near a platform in the upper middle section
-            int platformIndex = platforms.size() / 2 + 2; // Middle-upper platform
-            if (platformIndex < platforms.size()) {
+            int platformIndex = mainPathPlatformCount / 2 + 2; // Middle-upper platform
+            if (platformIndex < mainPathPlatformCount) {
                 const Platform& plat = platforms[platformIndex];
                 keyX = plat.x + plat.width / 2 + (rand() % 60 - 30); // Near platform center
                 keyY = plat.y + plat.height + 30 + (rand() % 40); // Above platform
@@ -2217,20 +5438,12 @@ void update(float deltaTime) {
             keyCollected = true;
             player.hasKey = true;
             score += 500;
-            // Start door unlock animation
-            doorIsUnlocking = true;
-            doorUnlockAnimTime = 0.0f;
+            sequences.start(doorUnlockSequence());
         }
     }
     
     // Update door animations
     doorAnimTime += deltaTime; // Always update for constant effects
-    if (doorIsUnlocking) {
-        doorUnlockAnimTime += deltaTime;
-        if (doorUnlockAnimTime >= 2.0f) {
-            doorIsUnlocking = false; // Unlock animation complete
-        }
-    }
     if (doorIsEntering) {
         doorEnterAnimTime += deltaTime;
     }
@@ -2239,7 +5452,7 @@ void update(float deltaTime) {
     powerUpSpawnTimer -= deltaTime;
     if (powerUpSpawnTimer <= 0 && powerUps.size() < 2) {
         int type = 1 + rand() % 2;
-        float x = 50 + rand() % (WIDTH - 100);
+        float x = powerUpZoneLeft + rand() % (int)(powerUpZoneRight - powerUpZoneLeft); // Terrain pattern's pickup band
         float y = lavaHeight + 100 + rand() % 200;
         powerUps.push_back({x, y, type, true, 15.0f, 0.0f}); // Last longer
         powerUpSpawnTimer = 10.0f + rand() % 8; // Spawn more often
@@ -2264,7 +5477,7 @@ void update(float deltaTime) {
             player.powerUpTimer = 12.0f; // Last longer when activated
             if (powerUp.type == 2) {
                 player.canDoubleJump = true;
-                playSound("game-bonus-02-294436.mp3");
+                queueSound("game-bonus-02-294436.mp3");
             }
             powerUp.active = false;
             score += 200;
@@ -2279,68 +5492,220 @@ void update(float deltaTime) {
     if (keyCollected && !doorIsEntering && !playerBeingSucked) {
         float doorX = WIDTH / 2 - 40;
         float doorY = HEIGHT - 150; // Match the door drawing position
-        if (checkCollision(player.x, player.y, player.width, player.height,
-                         doorX, doorY, 80, 120)) {
-            // Start suction animation
-            playerBeingSucked = true;
-            suctionAnimTime = 0.0f;
-            suctionStartX = player.x;
-            suctionStartY = player.y;
-            doorCenterX = doorX + 40; // Center of door
-            doorCenterY = doorY + 60;
-        }
-    }
-    
-    // Update suction animation
-    if (playerBeingSucked) {
-        suctionAnimTime += deltaTime;
-        
-        // Animation phases:
-        // Phase 1 (0-0.3s): Continue moving briefly in current direction
-        // Phase 2 (0.3-2.5s): Stop, rotate with increasing speed, move toward door
-        float continueDuration = 0.3f;
-        float suctionDuration = 2.5f;
-        float progress = std::min(1.0f, suctionAnimTime / suctionDuration);
-        
-        if (progress < 1.0f) {
-            if (suctionAnimTime < continueDuration) {
-                // Phase 1: Brief continuation of movement
-                float continueProgress = suctionAnimTime / continueDuration;
-                player.x += player.velocityX * deltaTime * (1.0f - continueProgress);
-                player.y += player.velocityY * deltaTime * (1.0f - continueProgress);
-            } else {
-                // Phase 2: Suction toward door
-                float suctionProgress = (suctionAnimTime - continueDuration) / (suctionDuration - continueDuration);
-                // Ease in cubic for smooth acceleration
-                float easeProgress = suctionProgress * suctionProgress * suctionProgress;
-                
-                player.x = suctionStartX + (doorCenterX - suctionStartX) * easeProgress;
-                player.y = suctionStartY + (doorCenterY - suctionStartY) * easeProgress;
-                
-                // Rotation with increasing speed (starts slow, gets faster)
-                float rotationSpeed = suctionProgress * suctionProgress * 1440.0f; // Accelerating rotation
-                playerFlipAngle = -suctionProgress * rotationSpeed;
-            }
-        } else {
-            // Animation complete - trigger win
-            gameState = GAME_WIN;
-            playSound("you-win-sequence-1-183948.mp3");
-            initFallingCharacters(); // Initialize falling characters for win screen
+        if (checkCollision(player.x, player.y, player.width, player.height,
+                         doorX, doorY, 80, 120)) {
+            sequences.start(doorSuctionSequence(doorX, doorY));
         }
-        
-        // Don't update other game elements during suction
-        return;
     }
     
+    // Advance the door sequences; ones started this tick take their first step now
+    sequences.tick(deltaTime);
+    if (playerBeingSucked) return; // Nothing else moves during suction
+    
     // Complete win after entrance animation finishes
     if (doorIsEntering && doorEnterAnimTime >= 1.5f) {
         gameState = GAME_WIN;
-        initFallingCharacters(); // Initialize falling characters for win screen
+        queueEffect(EFFECT_WIN_SCREEN, 0.0f, 0.0f); // Falling characters for the win screen
+    }
+}
+
+// Frame pacing: gameplay and the win celebration run at full rate. Other screens
+// only have ambient animation: full rate briefly after input, then a lower rate,
+// then an idle rate. Nothing is scheduled while the window is hidden, or while a
+// non-gameplay screen is unfocused; the next input or window event resumes at once.
+struct FrameScheduler {
+    bool windowVisible = true;
+    bool pointerInside = true;  // GLUT has no focus callback; pointer entry is the proxy
+    int lastInputTime = 0;      // GLUT_ELAPSED_TIME of the last input event
+    int generation = 0;         // Identifies the live timer; superseded callbacks are dropped
+    int intervalMs = 16;        // Interval the live timer was armed with (0 = stopped)
+    bool fixedPacing = false;   // --fixed-pacing: the original unconditional 16 ms timer, for comparison
+} frameScheduler;
+
+const int FULL_RATE_INTERVAL_MS = 16;  // ~60 FPS
+const int AMBIENT_INTERVAL_MS = 33;    // ~30 FPS for background drift on menus
+const int IDLE_INTERVAL_MS = 100;      // ~10 FPS when nobody is interacting
+const int INPUT_BOOST_MS = 2000;       // Full rate this long after input on menus
+const int IDLE_AFTER_MS = 10000;       // Drop to the idle rate after this long without input
+
+void timer(int value);
+
+// Timer interval for the current state (0 = don't schedule frames)
+int frameSchedulerInterval() {
+    if (frameScheduler.fixedPacing) return FULL_RATE_INTERVAL_MS;
+    if (!frameScheduler.windowVisible) return 0;
+    if (gameState == PLAYING || gameState == GAME_WIN) return FULL_RATE_INTERVAL_MS;
+    if (!frameScheduler.pointerInside) return 0;
+    
+    int sinceInput = glutGet(GLUT_ELAPSED_TIME) - frameScheduler.lastInputTime;
+    if (sinceInput < INPUT_BOOST_MS) return FULL_RATE_INTERVAL_MS;
+    if (sinceInput < IDLE_AFTER_MS) return AMBIENT_INTERVAL_MS;
+    return IDLE_INTERVAL_MS;
+}
+
+void armFrameTimer(int delayMs, int intervalMs) {
+    frameScheduler.intervalMs = intervalMs;
+    if (intervalMs > 0) {
+        glutTimerFunc(delayMs, timer, frameScheduler.generation);
+    }
+}
+
+// Input or window event: redraw now and replace a slow or stopped timer with an immediate one
+void frameSchedulerWake() {
+    frameScheduler.lastInputTime = glutGet(GLUT_ELAPSED_TIME);
+    if (frameScheduler.fixedPacing) return; // Input waits for the next timer frame
+    glutPostRedisplay();
+    int interval = frameSchedulerInterval();
+    if (interval > 0 && (frameScheduler.intervalMs == 0 || interval < frameScheduler.intervalMs)) {
+        frameScheduler.generation++;
+        armFrameTimer(0, interval);
+    }
+}
+
+// Apply one queued key event (simulation side)
+void applyInput(const InputEvent& event) {
+    switch (event.action) {
+        case INPUT_LEFT_DOWN:
+            if (!playerBeingSucked) leftPressed = true;
+            break;
+        case INPUT_LEFT_UP:
+            leftPressed = false;
+            break;
+        case INPUT_RIGHT_DOWN:
+            if (!playerBeingSucked) rightPressed = true;
+            break;
+        case INPUT_RIGHT_UP:
+            rightPressed = false;
+            break;
+        case INPUT_JUMP:
+            if (playerBeingSucked) break;
+            if (applyJump(player.velocityY, player.onGround, player.canDoubleJump, player.hasDoubleJumped)) {
+                // Start the flip, or restart it on a double jump
+                playerAirTime = 0.0f;
+                playerFlipAngle = 0.0f;
+            }
+            break;
+        case INPUT_QUIT:
+            gameState = START_MENU;
+            break;
+    }
+}
+
+// Simulate the deltaTime seconds ending at endMs. The queued input is applied
+// in order, each event at the moment it arrived, with update() run up to it first
+void runSimulationTick(float deltaTime, double endMs) {
+    double simMs = endMs - deltaTime * 1000.0;
+    InputEvent event;
+    while (inputEvents.pop(event)) {
+        if (event.game != inputGame.load(std::memory_order_acquire)) continue;
+        double at = std::min(std::max(event.timeMs, simMs), endMs);
+        if (at > simMs) update((at - simMs) / 1000.0);
+        applyInput(event);
+        simMs = at;
+        if (pendingInput.id == 0) {
+            pendingInput.id = event.id;
+            pendingInput.arrivalMs = event.timeMs;
+        }
+    }
+    if (endMs > simMs) update((endMs - simMs) / 1000.0);
+    if (pendingInput.id != 0 && pendingInput.appliedMs == 0.0) pendingInput.appliedMs = nowMs();
+}
+
+const double SIM_TICK_MS = 1000.0 / 120.0;
+
+bool simulationShouldRun() {
+    return gameState == PLAYING && frameScheduler.windowVisible;
+}
+
+// Tick update() while a game is in progress and publish a snapshot after each
+// tick, so a slow frame or buffer swap never holds up physics and a slow tick
+// never holds up a frame. Like the frame timer, it stops while the window is hidden
+void simulationLoop() {
+    std::unique_lock<std::mutex> lock(simulation.worldMutex);
+    double lastTick = nowMs();
+    while (true) {
+        if (!simulationShouldRun()) {
+            simulation.wake.wait(lock, simulationShouldRun);
+            lastTick = nowMs(); // Don't simulate the pause
+        }
+        simulation.ticking = true;
+        if (simulation.exiting) break;
+        double tickStart = nowMs();
+        runSimulationTick(std::min((tickStart - lastTick) / 1000.0, 0.1), tickStart);
+        publishRenderSnapshot(nowMs() - tickStart);
+        simulation.ticking = false;
+        lastTick = tickStart;
+        
+        // Sleep out the tick with the world unlocked for input handlers
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(tickStart + SIM_TICK_MS - nowMs()));
+        lock.lock();
     }
+    simulation.ticking = false;
+}
+
+// exit() destroys the game state: let a tick in flight finish and stop the next one
+void stopSimulation() {
+    simulation.exiting = true;
+    while (simulation.ticking) std::this_thread::yield();
+}
+
+void startSimulationThread() {
+    if (!simulation.enabled) return;
+    std::atexit(stopSimulation);
+    std::thread(simulationLoop).detach();
+}
+
+// Window shown or hidden
+void visibility(int state) {
+    std::lock_guard<std::mutex> lock(simulation.worldMutex);
+    frameScheduler.windowVisible = (state == GLUT_VISIBLE);
+    if (frameScheduler.windowVisible) frameSchedulerWake();
+    simulation.wake.notify_one();
+}
+
+// Pointer entered or left the window
+void entry(int state) {
+    frameScheduler.pointerInside = (state == GLUT_ENTERED);
+    if (frameScheduler.pointerInside) frameSchedulerWake();
 }
 
 // Keyboard input
+// Gameplay keys go to the simulation through inputEvents, stamped with the time
+// they arrived, so each takes effect at that moment within the tick that applies
+// it. Menu keys are handled here; the simulation is idle outside a game, and
+// locking the world waits out the tick that may have just ended one
+void queueInput(InputAction action) {
+    static uint32_t lastInputId = 0;
+    inputEvents.push({++lastInputId, nowMs(), action, inputGame.load(std::memory_order_relaxed)});
+}
+
 void keyboard(unsigned char key, int x, int y) {
+    frameSchedulerWake();
+    
+    if (gameState == PLAYING) {
+        switch (key) {
+            case 27: // ESC
+                queueInput(INPUT_QUIT);
+                break;
+            case 'a':
+            case 'A':
+                queueInput(INPUT_LEFT_DOWN);
+                break;
+            case 'd':
+            case 'D':
+                queueInput(INPUT_RIGHT_DOWN);
+                break;
+            case 'w':
+            case 'W':
+            case ' ':
+                queueInput(INPUT_JUMP);
+                break;
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(simulation.worldMutex);
     switch (key) {
         case 27: // ESC
             if (gameState == START_MENU) {
@@ -2362,6 +5727,8 @@ void keyboard(unsigned char key, int x, int y) {
                         keyCollected = false;
                         playSound("game-start-6104.mp3");
                         initGame();
+                        simulation.wake.notify_one();
+                        frameSchedulerWake(); // Menus may have stopped the timer; gameplay needs it
                         break;
                     case MENU_CHARACTER:
                         gameState = CHARACTER_SELECT;
@@ -2404,6 +5771,8 @@ void keyboard(unsigned char key, int x, int y) {
                         }
                         playSound("game-start-6104.mp3");
                         initGame();
+                        simulation.wake.notify_one();
+                        frameSchedulerWake(); // Menus may have stopped the timer; gameplay needs it
                         break;
                     case BUTTON_EXIT:
                         exit(0);
@@ -2417,56 +5786,49 @@ void keyboard(unsigned char key, int x, int y) {
                 gameState = START_MENU;
             }
             break;
-        case 'a':
-        case 'A':
-            if (gameState == PLAYING && !playerBeingSucked) {
-                leftPressed = true;
-            }
-            break;
-        case 'd':
-        case 'D':
-            if (gameState == PLAYING && !playerBeingSucked) {
-                rightPressed = true;
-            }
-            break;
-        case 'w':
-        case 'W':
-        case ' ':
-            if (gameState == PLAYING && !playerBeingSucked) {
-                if (player.onGround) {
-                    player.velocityY = 400; // Slightly lower jump
-                    player.onGround = false;
-                    // Start flip
-                    playerAirTime = 0.0f;
-                    playerFlipAngle = 0.0f;
-                } else if (player.canDoubleJump && !player.hasDoubleJumped) {
-                    player.velocityY = 310; // Slightly lower double jump
-                    player.hasDoubleJumped = true;
-                    // Restart flip on double jump
-                    playerAirTime = 0.0f;
-                    playerFlipAngle = 0.0f;
-                }
-            }
-            break;
     }
 }
 
 void keyboardUp(unsigned char key, int x, int y) {
+    frameSchedulerWake();
     if (gameState != PLAYING) return;
 
     switch (key) {
         case 'a':
         case 'A':
-            leftPressed = false;
+            queueInput(INPUT_LEFT_UP);
             break;
         case 'd':
         case 'D':
-            rightPressed = false;
+            queueInput(INPUT_RIGHT_UP);
             break;
     }
 }
 
 void specialKey(int key, int x, int y) {
+    frameSchedulerWake();
+    
+    if (key == GLUT_KEY_F3) {
+        profiler.overlayVisible = !profiler.overlayVisible;
+        return;
+    }
+    
+    if (gameState == PLAYING) {
+        switch (key) {
+            case GLUT_KEY_LEFT:
+                queueInput(INPUT_LEFT_DOWN);
+                break;
+            case GLUT_KEY_RIGHT:
+                queueInput(INPUT_RIGHT_DOWN);
+                break;
+            case GLUT_KEY_UP:
+                queueInput(INPUT_JUMP);
+                break;
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(simulation.worldMutex);
     if (gameState == START_MENU) {
         switch (key) {
             case GLUT_KEY_UP:
@@ -2494,136 +5856,167 @@ void specialKey(int key, int x, int y) {
                 currentWinLoseButton = (WinLoseButton)((currentWinLoseButton + 1) % 2);
                 break;
         }
-    } else if (gameState == PLAYING && !playerBeingSucked) {
-        switch (key) {
-            case GLUT_KEY_LEFT:
-                leftPressed = true;
-                break;
-            case GLUT_KEY_RIGHT:
-                rightPressed = true;
-                break;
-            case GLUT_KEY_UP:
-                if (player.onGround) {
-                    player.velocityY = 400; // Slightly lower jump
-                    player.onGround = false;
-                    // Start flip
-                    playerAirTime = 0.0f;
-                    playerFlipAngle = 0.0f;
-                } else if (player.canDoubleJump && !player.hasDoubleJumped) {
-                    player.velocityY = 310; // Slightly lower double jump
-                    player.hasDoubleJumped = true;
-                    // Restart flip on double jump
-                    playerAirTime = 0.0f;
-                    playerFlipAngle = 0.0f;
-                }
-                break;
-        }
     }
 }
 
 void specialKeyUp(int key, int x, int y) {
+    frameSchedulerWake();
     if (gameState != PLAYING) return;
 
     switch (key) {
         case GLUT_KEY_LEFT:
-            leftPressed = false;
+            queueInput(INPUT_LEFT_UP);
             break;
         case GLUT_KEY_RIGHT:
-            rightPressed = false;
+            queueInput(INPUT_RIGHT_UP);
             break;
     }
 }
 
-// Particle structure for floating elements
-struct BackgroundParticle {
-    float x, y;
-    float size;
-    float speed;
-    float alpha;
-};
-
-std::vector<BackgroundParticle> bgParticles;
 float bgAnimTime = 0.0f;
 
-// Initialize background particles
-void initBackgroundParticles() {
-    bgParticles.clear();
-    for (int i = 0; i < 50; i++) {
-        BackgroundParticle p;
-        p.x = rand() % WIDTH;
-        p.y = rand() % HEIGHT;
-        p.size = 2 + rand() % 4;
-        p.speed = 5 + rand() % 15;
-        p.alpha = 0.3f + (rand() % 50) / 100.0f;
-        bgParticles.push_back(p);
-    }
-}
-
 // Initialize falling characters for win screen
 void initFallingCharacters() {
     fallingCharacters.clear();
     characterSpawnTimer = 0.0f;
 }
 
+// Spawn, fall and spin the win screen's characters
+void updateFallingCharacters(float deltaTime) {
+    characterSpawnTimer += deltaTime;
+    if (characterSpawnTimer > 0.3f && fallingCharacters.size() < 15) {
+        FallingCharacter newChar;
+        newChar.x = rand() % WIDTH;
+        newChar.y = HEIGHT + 50;
+        newChar.type = (CharacterType)(rand() % 3); // Random character type
+        newChar.rotationSpeed = (rand() % 60) + 30; // 30-90 degrees per second
+        newChar.rotation = 0;
+        newChar.fallSpeed = (rand() % 100) + 150; // 150-250 pixels per second
+        newChar.scale = 0.5f + (rand() % 50) / 100.0f; // 0.5 to 1.0 scale
+        newChar.active = true;
+        fallingCharacters.push_back(newChar);
+        characterSpawnTimer = 0.0f;
+    }
+    
+    for (auto& character : fallingCharacters) {
+        character.y -= character.fallSpeed * deltaTime;
+        character.rotation += character.rotationSpeed * deltaTime;
+        if (character.y < -100) {
+            character.active = false;
+        }
+    }
+    
+    // Remove inactive characters
+    fallingCharacters.erase(
+        std::remove_if(fallingCharacters.begin(), fallingCharacters.end(),
+                      [](const FallingCharacter& c) { return !c.active; }),
+        fallingCharacters.end());
+}
+
+// Start the particles, sounds and win screen raised by the simulation since the last frame
+void playGameEffects() {
+    GameEffectEvent event;
+    while (gameEffects.pop(event)) {
+        switch (event.type) {
+            case EFFECT_ROCK_DEBRIS:
+                emitRockDebris(event.x, event.y);
+                break;
+            case EFFECT_COIN_SPARKLES:
+                emitCoinSparkles(event.x, event.y);
+                break;
+            case EFFECT_SOUND:
+                playSound(event.sound);
+                break;
+            case EFFECT_WIN_SCREEN:
+                initFallingCharacters();
+                break;
+        }
+    }
+}
+
+void takeRenderSnapshot();
+
+// Advance purely visual animation state. Draw functions only read this state,
+// so a frame can be rendered any number of times without changing it.
+void updateCosmetics(float deltaTime) {
+    takeRenderSnapshot();
+    playGameEffects();
+    const RenderSnapshot& frame = renderSnapshots.front();
+    bgAnimTime += deltaTime;
+    logoGlowTime += deltaTime;
+    updateParticles(ambientParticles, deltaTime);
+    if (gameState == PLAYING) {
+        emitLavaEmbers(deltaTime);
+    }
+    if (frame.playerBeingSucked) {
+        emitSuctionSpiral(deltaTime);
+    }
+    updateParticles(effectParticles, deltaTime);
+    if (gameState == GAME_WIN) {
+        updateFallingCharacters(deltaTime);
+    }
+}
+
 // Draw epic animated parallax background
 void drawLayeredBackground() {
-    // Initialize particles if empty
-    if (bgParticles.empty()) {
-        initBackgroundParticles();
-    }
+    const QualitySettings& detail = qualitySettings();
     
     // Vice City style sunset gradient with color cycling
     float sunsetCycle = sin(bgAnimTime * 0.2f) * 0.3f + 0.7f; // Slower, more subtle cycling
     
     // Vintage sunset gradient - top to bottom
-    glBegin(GL_QUADS);
-    // Sky top - deep purple/magenta
-    glColor3f(0.3f * sunsetCycle, 0.1f * sunsetCycle, 0.5f * sunsetCycle);
-    glVertex2f(0, HEIGHT);
-    glVertex2f(WIDTH, HEIGHT);
-    
-    // Upper middle - pink/orange blend
-    glColor3f(0.8f * sunsetCycle, 0.3f * sunsetCycle, 0.6f * sunsetCycle);
-    glVertex2f(WIDTH, HEIGHT * 0.75f);
-    glVertex2f(0, HEIGHT * 0.75f);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    // Mid horizon - bright orange/yellow
-    glColor3f(0.8f * sunsetCycle, 0.3f * sunsetCycle, 0.6f * sunsetCycle);
-    glVertex2f(0, HEIGHT * 0.75f);
-    glVertex2f(WIDTH, HEIGHT * 0.75f);
-    
-    glColor3f(1.0f * sunsetCycle, 0.5f * sunsetCycle, 0.2f * sunsetCycle);
-    glVertex2f(WIDTH, HEIGHT * 0.5f);
-    glVertex2f(0, HEIGHT * 0.5f);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    // Lower horizon - deep orange to dark
-    glColor3f(1.0f * sunsetCycle, 0.5f * sunsetCycle, 0.2f * sunsetCycle);
-    glVertex2f(0, HEIGHT * 0.5f);
-    glVertex2f(WIDTH, HEIGHT * 0.5f);
-    
-    glColor3f(0.4f * sunsetCycle, 0.2f * sunsetCycle, 0.4f * sunsetCycle);
-    glVertex2f(WIDTH, HEIGHT * 0.25f);
-    glVertex2f(0, HEIGHT * 0.25f);
-    glEnd();
-    
-    glBegin(GL_QUADS);
-    // Bottom - dark purple/black
-    glColor3f(0.4f * sunsetCycle, 0.2f * sunsetCycle, 0.4f * sunsetCycle);
-    glVertex2f(0, HEIGHT * 0.25f);
-    glVertex2f(WIDTH, HEIGHT * 0.25f);
-    
-    glColor3f(0.1f, 0.05f, 0.15f);
-    glVertex2f(WIDTH, 0);
-    glVertex2f(0, 0);
-    glEnd();
+    if (renderBackend == RENDER_CORE) {
+        coreDrawSunset(sunsetCycle);
+    } else {
+        gfxBegin(GL_QUADS);
+        // Sky top - deep purple/magenta
+        gfxColor3f(0.3f * sunsetCycle, 0.1f * sunsetCycle, 0.5f * sunsetCycle);
+        gfxVertex2f(0, HEIGHT);
+        gfxVertex2f(WIDTH, HEIGHT);
+        
+        // Upper middle - pink/orange blend
+        gfxColor3f(0.8f * sunsetCycle, 0.3f * sunsetCycle, 0.6f * sunsetCycle);
+        gfxVertex2f(WIDTH, HEIGHT * 0.75f);
+        gfxVertex2f(0, HEIGHT * 0.75f);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        // Mid horizon - bright orange/yellow
+        gfxColor3f(0.8f * sunsetCycle, 0.3f * sunsetCycle, 0.6f * sunsetCycle);
+        gfxVertex2f(0, HEIGHT * 0.75f);
+        gfxVertex2f(WIDTH, HEIGHT * 0.75f);
+        
+        gfxColor3f(1.0f * sunsetCycle, 0.5f * sunsetCycle, 0.2f * sunsetCycle);
+        gfxVertex2f(WIDTH, HEIGHT * 0.5f);
+        gfxVertex2f(0, HEIGHT * 0.5f);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        // Lower horizon - deep orange to dark
+        gfxColor3f(1.0f * sunsetCycle, 0.5f * sunsetCycle, 0.2f * sunsetCycle);
+        gfxVertex2f(0, HEIGHT * 0.5f);
+        gfxVertex2f(WIDTH, HEIGHT * 0.5f);
+        
+        gfxColor3f(0.4f * sunsetCycle, 0.2f * sunsetCycle, 0.4f * sunsetCycle);
+        gfxVertex2f(WIDTH, HEIGHT * 0.25f);
+        gfxVertex2f(0, HEIGHT * 0.25f);
+        gfxEnd();
+        
+        gfxBegin(GL_QUADS);
+        // Bottom - dark purple/black
+        gfxColor3f(0.4f * sunsetCycle, 0.2f * sunsetCycle, 0.4f * sunsetCycle);
+        gfxVertex2f(0, HEIGHT * 0.25f);
+        gfxVertex2f(WIDTH, HEIGHT * 0.25f);
+        
+        gfxColor3f(0.1f, 0.05f, 0.15f);
+        gfxVertex2f(WIDTH, 0);
+        gfxVertex2f(0, 0);
+        gfxEnd();
+    }
     
     // Distant skyscrapers layer (slowest parallax)
     float backBuildingOffset = fmod(bgAnimTime * 5.0f, WIDTH + 400);
-    glColor4f(0.1f, 0.05f, 0.2f, 0.6f); // Dark silhouette
+    gfxColor4f(0.1f, 0.05f, 0.2f, 0.6f); // Dark silhouette
     
     // Draw distant skyscraper silhouettes
     for (int i = 0; i < 8; i++) {
@@ -2634,37 +6027,37 @@ void drawLayeredBackground() {
         float buildingWidth = 25 + (i * 7) % 15;
         
         // Main building rectangle
-        glBegin(GL_QUADS);
-        glVertex2f(buildingX, HEIGHT * 0.35f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.35f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.35f + buildingHeight);
-        glVertex2f(buildingX, HEIGHT * 0.35f + buildingHeight);
-        glEnd();
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(buildingX, HEIGHT * 0.35f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.35f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.35f + buildingHeight);
+        gfxVertex2f(buildingX, HEIGHT * 0.35f + buildingHeight);
+        gfxEnd();
         
         // Window lights (some buildings have lights on)
-        if (i % 2 == 0) {
-            glColor4f(1.0f, 0.9f, 0.6f, 0.8f);
+        if (i % 2 == 0 && detail.distantWindowLights) {
+            gfxColor4f(1.0f, 0.9f, 0.6f, 0.8f);
             for (int w = 0; w < 3; w++) {
                 for (int h = 0; h < (int)(buildingHeight / 15); h++) {
                     if ((w + h + i) % 3 == 0) { // Random pattern
                         float winX = buildingX + 3 + w * 7;
                         float winY = HEIGHT * 0.35f + 5 + h * 15;
-                        glBegin(GL_QUADS);
-                        glVertex2f(winX, winY);
-                        glVertex2f(winX + 4, winY);
-                        glVertex2f(winX + 4, winY + 8);
-                        glVertex2f(winX, winY + 8);
-                        glEnd();
+                        gfxBegin(GL_QUADS);
+                        gfxVertex2f(winX, winY);
+                        gfxVertex2f(winX + 4, winY);
+                        gfxVertex2f(winX + 4, winY + 8);
+                        gfxVertex2f(winX, winY + 8);
+                        gfxEnd();
                     }
                 }
             }
-            glColor4f(0.1f, 0.05f, 0.2f, 0.6f); // Reset color
+            gfxColor4f(0.1f, 0.05f, 0.2f, 0.6f); // Reset color
         }
     }
     
     // Middle skyscrapers layer (medium parallax)
     float midBuildingOffset = fmod(bgAnimTime * 10.0f, WIDTH + 300);
-    glColor4f(0.15f, 0.08f, 0.25f, 0.7f);
+    gfxColor4f(0.15f, 0.08f, 0.25f, 0.7f);
     
     for (int i = 0; i < 6; i++) {
         float buildingX = midBuildingOffset + i * 120 - 200;
@@ -2674,43 +6067,43 @@ void drawLayeredBackground() {
         float buildingWidth = 35 + (i * 11) % 20;
         
         // Main building
-        glBegin(GL_QUADS);
-        glVertex2f(buildingX, HEIGHT * 0.3f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.3f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.3f + buildingHeight);
-        glVertex2f(buildingX, HEIGHT * 0.3f + buildingHeight);
-        glEnd();
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(buildingX, HEIGHT * 0.3f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.3f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.3f + buildingHeight);
+        gfxVertex2f(buildingX, HEIGHT * 0.3f + buildingHeight);
+        gfxEnd();
         
         // Antenna/spires on some buildings
         if (i % 3 == 1) {
-            glBegin(GL_LINES);
-            glVertex2f(buildingX + buildingWidth/2, HEIGHT * 0.3f + buildingHeight);
-            glVertex2f(buildingX + buildingWidth/2, HEIGHT * 0.3f + buildingHeight + 20);
-            glEnd();
+            gfxBegin(GL_LINES);
+            gfxVertex2f(buildingX + buildingWidth/2, HEIGHT * 0.3f + buildingHeight);
+            gfxVertex2f(buildingX + buildingWidth/2, HEIGHT * 0.3f + buildingHeight + 20);
+            gfxEnd();
         }
         
         // More detailed windows
-        glColor4f(1.0f, 0.8f, 0.4f, 0.9f);
-        for (int w = 0; w < (int)(buildingWidth / 8); w++) {
+        gfxColor4f(1.0f, 0.8f, 0.4f, 0.9f);
+        for (int w = 0; detail.nearWindowLights && w < (int)(buildingWidth / 8); w++) {
             for (int h = 0; h < (int)(buildingHeight / 12); h++) {
                 if ((w + h + i * 2) % 4 != 0) {
                     float winX = buildingX + 2 + w * 8;
                     float winY = HEIGHT * 0.3f + 3 + h * 12;
-                    glBegin(GL_QUADS);
-                    glVertex2f(winX, winY);
-                    glVertex2f(winX + 5, winY);
-                    glVertex2f(winX + 5, winY + 6);
-                    glVertex2f(winX, winY + 6);
-                    glEnd();
+                    gfxBegin(GL_QUADS);
+                    gfxVertex2f(winX, winY);
+                    gfxVertex2f(winX + 5, winY);
+                    gfxVertex2f(winX + 5, winY + 6);
+                    gfxVertex2f(winX, winY + 6);
+                    gfxEnd();
                 }
             }
         }
-        glColor4f(0.15f, 0.08f, 0.25f, 0.7f);
+        gfxColor4f(0.15f, 0.08f, 0.25f, 0.7f);
     }
     
     // Foreground skyscrapers (fastest parallax)
     float frontBuildingOffset = fmod(bgAnimTime * 20.0f, WIDTH + 250);
-    glColor4f(0.08f, 0.04f, 0.15f, 0.8f);
+    gfxColor4f(0.08f, 0.04f, 0.15f, 0.8f);
     
     for (int i = 0; i < 4; i++) {
         float buildingX = frontBuildingOffset + i * 200 - 200;
@@ -2720,109 +6113,73 @@ void drawLayeredBackground() {
         float buildingWidth = 50 + (i * 13) % 30;
         
         // Main building silhouette
-        glBegin(GL_QUADS);
-        glVertex2f(buildingX, HEIGHT * 0.25f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.25f);
-        glVertex2f(buildingX + buildingWidth, HEIGHT * 0.25f + buildingHeight);
-        glVertex2f(buildingX, HEIGHT * 0.25f + buildingHeight);
-        glEnd();
+        gfxBegin(GL_QUADS);
+        gfxVertex2f(buildingX, HEIGHT * 0.25f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.25f);
+        gfxVertex2f(buildingX + buildingWidth, HEIGHT * 0.25f + buildingHeight);
+        gfxVertex2f(buildingX, HEIGHT * 0.25f + buildingHeight);
+        gfxEnd();
         
         // Building details - stepped tops
         if (i % 2 == 0) {
-            glBegin(GL_QUADS);
-            glVertex2f(buildingX + 10, HEIGHT * 0.25f + buildingHeight);
-            glVertex2f(buildingX + buildingWidth - 10, HEIGHT * 0.25f + buildingHeight);
-            glVertex2f(buildingX + buildingWidth - 10, HEIGHT * 0.25f + buildingHeight + 15);
-            glVertex2f(buildingX + 10, HEIGHT * 0.25f + buildingHeight + 15);
-            glEnd();
+            gfxBegin(GL_QUADS);
+            gfxVertex2f(buildingX + 10, HEIGHT * 0.25f + buildingHeight);
+            gfxVertex2f(buildingX + buildingWidth - 10, HEIGHT * 0.25f + buildingHeight);
+            gfxVertex2f(buildingX + buildingWidth - 10, HEIGHT * 0.25f + buildingHeight + 15);
+            gfxVertex2f(buildingX + 10, HEIGHT * 0.25f + buildingHeight + 15);
+            gfxEnd();
         }
         
         // Bright windows creating city atmosphere
-        glColor4f(1.0f, 0.9f, 0.7f, 1.0f);
-        for (int w = 0; w < (int)(buildingWidth / 10); w++) {
+        gfxColor4f(1.0f, 0.9f, 0.7f, 1.0f);
+        for (int w = 0; detail.nearWindowLights && w < (int)(buildingWidth / 10); w++) {
             for (int h = 0; h < (int)(buildingHeight / 15); h++) {
                 if ((w * 3 + h + i) % 5 != 0) {
                     float winX = buildingX + 3 + w * 10;
                     float winY = HEIGHT * 0.25f + 5 + h * 15;
-                    glBegin(GL_QUADS);
-                    glVertex2f(winX, winY);
-                    glVertex2f(winX + 6, winY);
-                    glVertex2f(winX + 6, winY + 8);
-                    glVertex2f(winX, winY + 8);
-                    glEnd();
+                    gfxBegin(GL_QUADS);
+                    gfxVertex2f(winX, winY);
+                    gfxVertex2f(winX + 6, winY);
+                    gfxVertex2f(winX + 6, winY + 8);
+                    gfxVertex2f(winX, winY + 8);
+                    gfxEnd();
                 }
             }
         }
-        glColor4f(0.08f, 0.04f, 0.15f, 0.8f);
+        gfxColor4f(0.08f, 0.04f, 0.15f, 0.8f);
     }
     
     // Atmospheric particles (modified for Vice City vibe)
-    for (auto& particle : bgParticles) {
-        // Update particle position with slower drift
-        particle.y += particle.speed * 0.008f; // Slower floating for atmospheric effect
-        if (particle.y > HEIGHT + 20) {
-            particle.y = -20;
-            particle.x = rand() % WIDTH;
-        }
-        
-        // Different particles: some are city lights, others are atmospheric dust
-        float pulse = sin(bgAnimTime * 1.5f + particle.x * 0.01f) * 0.4f + 0.6f;
-        
-        if ((int)particle.x % 3 == 0) {
-            // City light reflections - pink/magenta tint
-            glColor4f(1.0f * pulse, 0.4f * pulse, 0.8f * pulse, particle.alpha * 0.6f);
-        } else {
-            // Warm atmospheric particles - orange/yellow
-            glColor4f(1.0f * pulse, 0.8f * pulse, 0.3f * pulse, particle.alpha * 0.4f);
-        }
-        
-        // Draw as small glowing points
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 6; i++) {
-            float angle = 2.0f * M_PI * i / 6;
-            glVertex2f(particle.x + particle.size * cos(angle), 
-                      particle.y + particle.size * sin(angle));
-        }
-        glEnd();
-        
-        // Add subtle glow
-        glColor4f(1.0f, 0.6f, 0.4f, particle.alpha * pulse * 0.2f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i < 6; i++) {
-            float angle = 2.0f * M_PI * i / 6;
-            glVertex2f(particle.x + (particle.size + 1) * cos(angle), 
-                      particle.y + (particle.size + 1) * sin(angle));
-        }
-        glEnd();
-    }
+    drawParticles(ambientParticles, bgAnimTime, detail.particleStride, detail.particleGlow);
     
     // Add subtle grid lines in the distance for retro-futuristic effect
-    glColor4f(0.3f * sunsetCycle, 0.1f * sunsetCycle, 0.4f * sunsetCycle, 0.15f);
+    gfxColor4f(0.3f * sunsetCycle, 0.1f * sunsetCycle, 0.4f * sunsetCycle, 0.15f);
     float gridOffset = fmod(bgAnimTime * 30.0f, 50.0f);
     
     // Horizontal grid lines
     for (int i = -2; i < HEIGHT / 25; i++) {
         float lineY = i * 25 + gridOffset;
         if (lineY > HEIGHT * 0.5f) {
-            glBegin(GL_LINES);
-            glVertex2f(0, lineY);
-            glVertex2f(WIDTH, lineY);
-            glEnd();
+            gfxBegin(GL_LINES);
+            gfxVertex2f(0, lineY);
+            gfxVertex2f(WIDTH, lineY);
+            gfxEnd();
         }
     }
     
     // Semi-transparent overlay for depth blur effect
-    glColor4f(0.05f, 0.05f, 0.1f, 0.15f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WIDTH, 0);
-    glVertex2f(WIDTH, HEIGHT);
-    glVertex2f(0, HEIGHT);
-    glEnd();
+    gfxColor4f(0.05f, 0.05f, 0.1f, 0.15f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(0, 0);
+    gfxVertex2f(WIDTH, 0);
+    gfxVertex2f(WIDTH, HEIGHT);
+    gfxVertex2f(0, HEIGHT);
+    gfxEnd();
 }
 
-// Measure text width using GLUT bitmap widths
+// Measure text width using GLUT bitmap widths (fixed advance for the core font)
 int measureTextWidth(const char* text) {
+    if (renderBackend == RENDER_CORE) return (int)strlen(text) * CORE_GLYPH_ADVANCE;
     int w = 0;
     while (*text) { w += glutBitmapWidth(GLUT_BITMAP_HELVETICA_18, *text++); }
     return w;
@@ -2922,18 +6279,205 @@ void drawCharacterSelect() {
     drawShadowedTextCentered(centerX, 40, hint, 0.9f, 0.9f, 0.9f);
 }
 
+// Retained menu layer: a menu screen's panels, texts and logo only change with the
+// selection, so they are compiled into a display list once and replayed every frame
+// on top of the animated background. The list is recompiled when its content key changes.
+// The core renderer keeps the same geometry in a static VBO instead.
+struct MenuLayerCache {
+    GLuint list = 0;
+    CoreRetainedBatch retained;
+    int contentKey = -1;
+};
+MenuLayerCache startMenuLayer;
+MenuLayerCache characterSelectLayer;
+bool menuCacheEnabled = true;
+
+void drawCachedMenuLayer(MenuLayerCache& cache, int contentKey, void (*drawFn)()) {
+    if (!menuCacheEnabled) {
+        drawFn();
+        return;
+    }
+    
+    if (renderBackend == RENDER_CORE) {
+        if (cache.contentKey != contentKey) {
+            coreBeginRetained(cache.retained);
+            drawFn();
+            coreEndRetained();
+            cache.contentKey = contentKey;
+        }
+        coreDrawRetained(cache.retained);
+        return;
+    }
+    
+    if (cache.list == 0) {
+        cache.list = glGenLists(1);
+        cache.contentKey = -1;
+    }
+    if (cache.contentKey != contentKey) {
+        glNewList(cache.list, GL_COMPILE);
+        drawFn();
+        glEndList();
+        cache.contentKey = contentKey;
+    }
+    glCallList(cache.list);
+}
+
+// Record the cost of one update() tick
+void profilerRecordUpdate(double ms) {
+    profiler.updateMs += (ms - profiler.updateMs) * 0.05;
+    profiler.reportUpdateSum += ms;
+    profiler.reportUpdateMax = std::max(profiler.reportUpdateMax, ms);
+    profiler.reportTicks++;
+}
+
+// Move the renderer onto the newest snapshot, count the tick that made it and
+// measure the input it applied
+void takeRenderSnapshot() {
+    if (!renderSnapshots.acquire()) return;
+    const RenderSnapshot& frame = renderSnapshots.front();
+    profilerRecordUpdate(frame.updateMs);
+    if (frame.input.id > profiler.lastInputId) {
+        profiler.lastInputId = frame.input.id;
+        profiler.inputToSim.record(frame.input.appliedMs - frame.input.arrivalMs);
+        profiler.inputAwaitingSwap = frame.input.arrivalMs;
+    }
+}
+
+// Record one displayed frame and emit telemetry every two seconds
+void profilerRecordFrame(double frameStart, double renderMs, double swapMs) {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    if (profiler.lastFrameStart > 0.0) {
+        profiler.frameMs += (frameStart - profiler.lastFrameStart - profiler.frameMs) * 0.05;
+    }
+    profiler.lastFrameStart = frameStart;
+    profiler.renderMs += (renderMs - profiler.renderMs) * 0.05;
+    profiler.swapMs += (swapMs - profiler.swapMs) * 0.05;
+    profiler.reportRenderSum += renderMs;
+    profiler.reportSwapSum += swapMs;
+    profiler.reportRenderMax = std::max(profiler.reportRenderMax, renderMs);
+    profiler.reportFrames++;
+    if (profiler.inputAwaitingSwap > 0.0) {
+        profiler.inputToSwap.record(frameStart + renderMs + swapMs - profiler.inputAwaitingSwap);
+        profiler.inputAwaitingSwap = 0.0;
+    }
+    
+    // Task scheduler rates, sampled once a second
+    double taskElapsed = frameStart - profiler.taskSampleStart;
+    if (taskElapsed >= 1000.0) {
+        TaskStats totals = tasks.stats();
+        if (profiler.taskSampleStart > 0.0) {
+            profiler.tasksPerSecond = (totals.tasksRun - profiler.taskTotals.tasksRun) * 1000.0 / taskElapsed;
+            profiler.stealsPerSecond = (totals.steals - profiler.taskTotals.steals) * 1000.0 / taskElapsed;
+            // A sleep is credited when it ends, so one spanning two samples can overshoot
+            profiler.workerIdlePercent = std::min(100.0, 100.0 * (totals.idleMs - profiler.taskTotals.idleMs) /
+                                                         (taskElapsed * std::max(1, tasks.workerCount())));
+        }
+        profiler.taskTotals = totals;
+        profiler.taskSampleStart = frameStart;
+    }
+    
+    // Periodic telemetry line so scaling runs can be captured from a terminal
+    if (profiler.reportStart == 0.0) profiler.reportStart = frameStart;
+    double elapsed = frameStart - profiler.reportStart;
+    if ((stress.enabled || profiler.latencyReport) && elapsed >= 2000.0) {
+        int frames = std::max(1, profiler.reportFrames);
+        int ticks = std::max(1, profiler.reportTicks);
+        if (stress.enabled) fprintf(stderr,
+                "[stress] platforms=%zu rocks=%zu coins=%zu particles=%zu | "
+                "update avg %.3f max %.3f ms | effects %.3f ms | render avg %.3f max %.3f ms | swap avg %.3f ms | %.1f fps | quality %d | "
+                "tasks %.0f/s steals %.0f/s idle %.0f%%\n",
+                frame.platforms.size(), frame.rocks.size(), frame.collectables.size(),
+                ambientParticles.count() + effectParticles.count(),
+                profiler.reportUpdateSum / ticks, profiler.reportUpdateMax, profiler.cosmeticsMs,
+                profiler.reportRenderSum / frames, profiler.reportRenderMax,
+                profiler.reportSwapSum / frames, profiler.reportFrames * 1000.0 / elapsed, quality.level,
+                profiler.tasksPerSecond, profiler.stealsPerSecond, profiler.workerIdlePercent);
+        const LatencyHistogram& sim = profiler.inputToSim;
+        const LatencyHistogram& swap = profiler.inputToSwap;
+        fprintf(stderr,
+                "[latency] %d inputs | input->sim p50 %.1f p95 %.1f p99 %.1f max %.1f ms | "
+                "input->swap p50 %.1f p95 %.1f p99 %.1f max %.1f ms | %s pacing, %s\n",
+                sim.total, sim.percentile(0.5), sim.percentile(0.95), sim.percentile(0.99), sim.maxMs,
+                swap.percentile(0.5), swap.percentile(0.95), swap.percentile(0.99), swap.maxMs,
+                frameScheduler.fixedPacing ? "fixed 16 ms" : "adaptive",
+                simulation.enabled ? "sim thread" : "sim on timer");
+        profiler.inputToSim.clear();
+        profiler.inputToSwap.clear();
+        profiler.reportStart = frameStart;
+        profiler.reportUpdateSum = profiler.reportRenderSum = profiler.reportSwapSum = 0.0;
+        profiler.reportUpdateMax = profiler.reportRenderMax = 0.0;
+        profiler.reportTicks = profiler.reportFrames = 0;
+    }
+}
+
+// Draw profiler overlay (top-left corner)
+void drawProfilerOverlay() {
+    const RenderSnapshot& frame = renderSnapshots.front();
+    std::vector<std::string> lines;
+    std::stringstream ss;
+    ss.setf(std::ios::fixed);
+    ss.precision(2);
+    ss << "FPS: " << (profiler.frameMs > 0.0 ? 1000.0 / profiler.frameMs : 0.0);
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Update: " << profiler.updateMs << " ms  Effects: " << profiler.cosmeticsMs << " ms";
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Render: " << profiler.renderMs << " ms  Swap: " << profiler.swapMs << " ms";
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Platforms: " << frame.platforms.size() << "  Rocks: " << frame.rocks.size();
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Coins: " << frame.collectables.size() << "  Particles: " << ambientParticles.count() + effectParticles.count();
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Input to sim p50/p95: " << profiler.inputToSim.percentile(0.5) << " / " << profiler.inputToSim.percentile(0.95) << " ms";
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Input to swap p50/p95: " << profiler.inputToSwap.percentile(0.5) << " / " << profiler.inputToSwap.percentile(0.95) << " ms";
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Tasks: " << (int)profiler.tasksPerSecond << "/s  Steals: " << (int)profiler.stealsPerSecond
+       << "/s  Idle: " << (int)profiler.workerIdlePercent << "% of " << tasks.workerCount();
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Frame interval: ";
+    if (frameScheduler.intervalMs > 0) ss << frameScheduler.intervalMs << " ms";
+    else ss << "stopped";
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Quality: " << quality.level << "/" << (QUALITY_LEVEL_COUNT - 1) << (quality.pinned ? " (pinned)" : " (auto)");
+    lines.push_back(ss.str()); ss.str("");
+    ss << "Renderer: " << (renderBackend == RENDER_CORE ? "core (GL 3.3)" : "legacy");
+    lines.push_back(ss.str()); ss.str("");
+    
+    float panelW = 300.0f;
+    for (const std::string& line : lines) {
+        panelW = std::max(panelW, measureTextWidth(line.c_str()) + 14.0f);
+    }
+    float panelH = 12.0f + 20.0f * lines.size();
+    gfxColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+    gfxBegin(GL_QUADS);
+    gfxVertex2f(5, HEIGHT - 5 - panelH);
+    gfxVertex2f(5 + panelW, HEIGHT - 5 - panelH);
+    gfxVertex2f(5 + panelW, HEIGHT - 5);
+    gfxVertex2f(5, HEIGHT - 5);
+    gfxEnd();
+    
+    for (size_t i = 0; i < lines.size(); i++) {
+        drawShadowedText(12, HEIGHT - 25 - 20.0f * i, lines[i].c_str(), 0.6f, 1.0f, 0.6f);
+    }
+}
 
 // Display function
 void display() {
+    double frameStart = nowMs();
+    pollAssets();
+    takeRenderSnapshot();
     glClear(GL_COLOR_BUFFER_BIT);
-    glLoadIdentity();
+    gfxLoadIdentity();
     
     if (gameState == START_MENU) {
         drawLayeredBackground();
-        drawStartMenu();
+        drawCachedMenuLayer(startMenuLayer, currentMenuSelection * 2 + (logoTexture != 0), drawStartMenu);
+        if (logoTexture == 0) {
+            drawIcyTowerLogoPixelArt(WIDTH / 2.0f, HEIGHT - 100); // Animated, so drawn outside the cache
+        }
     } else if (gameState == CHARACTER_SELECT) {
         drawLayeredBackground();
-        drawCharacterSelect();
+        drawCachedMenuLayer(characterSelectLayer, currentCharacterSelection, drawCharacterSelect);
     } else if (gameState == PLAYING) {
         drawLayeredBackground();
         drawLava();
@@ -2944,65 +6488,336 @@ void display() {
         drawRocks();
         drawPlayer();
         drawDoor();
+        drawParticles(effectParticles, bgAnimTime, qualitySettings().particleStride, false);
         drawHUD();
     } else if (gameState == GAME_OVER) {
-        drawLayeredBackground();
-        drawGameOver();
+        drawGameOver(); // Draws its own background
     } else if (gameState == GAME_WIN) {
-        drawLayeredBackground();
-        drawGameWin();
+        drawGameWin(); // Draws its own background
+    }
+    
+    if (profiler.overlayVisible) {
+        drawProfilerOverlay();
     }
+    gfxFlush();
     
+    double swapStart = nowMs();
     glutSwapBuffers();
+    profilerRecordFrame(frameStart, swapStart - frameStart, nowMs() - swapStart);
+    updateQualityGovernor(profiler.renderMs + profiler.updateMs);
 }
 
 // Timer function for consistent updates
 void timer(int value) {
+    if (value != frameScheduler.generation) return; // Superseded by a wake-up
+    
     static int lastTime = glutGet(GLUT_ELAPSED_TIME);
     int currentTime = glutGet(GLUT_ELAPSED_TIME);
     float deltaTime = (currentTime - lastTime) / 1000.0f;
     lastTime = currentTime;
     
+    // The timer may have been stopped (hidden window); don't simulate the gap
+    deltaTime = std::min(deltaTime, 0.1f);
+    
     // Always update background animation
-    bgAnimTime += deltaTime;
+    double cosmeticsStart = nowMs();
+    updateCosmetics(deltaTime);
+    profiler.cosmeticsMs += (nowMs() - cosmeticsStart - profiler.cosmeticsMs) * 0.05;
     
     if (gameState == PLAYING) {
-        update(deltaTime);
+        if (!simulation.enabled) {
+            double updateStart = nowMs();
+            runSimulationTick(deltaTime, updateStart);
+            publishRenderSnapshot(nowMs() - updateStart);
+        }
     } else {
         // Update menu animations
         menuAnimTime += deltaTime;
     }
     
     glutPostRedisplay();
-    glutTimerFunc(16, timer, 0); // ~60 FPS
+    // Re-evaluated every frame, so a game the simulation ended drops to the menu rate here
+    int interval = frameSchedulerInterval();
+    armFrameTimer(interval, interval);
 }
 
 // Reshape function
 void reshape(int width, int height) {
     glViewport(0, 0, width, height);
+    if (renderBackend == RENDER_CORE) {
+        coreSetProjection(0, WIDTH, 0, HEIGHT);
+        return;
+    }
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glOrtho(0, WIDTH, 0, HEIGHT, -1, 1);
     glMatrixMode(GL_MODELVIEW);
 }
 
+// Rasterise the sprite artwork into the atlas: draw every sprite into its cell of
+// the back buffer, then copy that rectangle into a texture. Colour is blended as
+// usual but alpha accumulates as coverage, so the result is premultiplied alpha.
+void initSpriteAtlas() {
+    const int atlasWidth = 512, atlasHeight = 256;
+    const float pixelsPerUnit = 2.0f; // Rasterised at twice the on-screen size
+    float halfSizes[SPRITE_COUNT];
+    for (int i = 0; i < COIN_FRAME_COUNT; i++) halfSizes[SPRITE_COIN_FIRST + i] = 12.0f;
+    halfSizes[SPRITE_KEY] = 22.0f;
+    halfSizes[SPRITE_SHIELD] = 13.0f;
+    halfSizes[SPRITE_WINGS] = 16.0f;
+    halfSizes[SPRITE_HEART_ICON] = 7.0f;
+    halfSizes[SPRITE_COIN_ICON] = 6.0f;
+    halfSizes[SPRITE_KEY_ICON] = 12.0f;
+    
+    glViewport(0, 0, atlasWidth, atlasHeight);
+    if (renderBackend == RENDER_CORE) {
+        coreSetProjection(0, atlasWidth, 0, atlasHeight);
+    } else {
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, atlasWidth, 0, atlasHeight, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+    }
+    gfxLoadIdentity();
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // Shelf packing, left to right and bottom to top, with a 2px gutter
+    int cursorX = 0, cursorY = 0, shelfHeight = 0;
+    bool fits = true;
+    for (int sprite = 0; sprite < SPRITE_COUNT; sprite++) {
+        int cell = (int)ceil(halfSizes[sprite] * 2 * pixelsPerUnit) + 2;
+        if (cursorX + cell > atlasWidth) {
+            cursorX = 0;
+            cursorY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (cursorY + cell > atlasHeight) {
+            fits = false;
+            break;
+        }
+        
+        float centerX = cursorX + cell / 2.0f, centerY = cursorY + cell / 2.0f;
+        float half = halfSizes[sprite] * pixelsPerUnit;
+        atlas.regions[sprite] = {(centerX - half) / atlasWidth, (centerY - half) / atlasHeight,
+                                 (centerX + half) / atlasWidth, (centerY + half) / atlasHeight, halfSizes[sprite]};
+        
+        gfxPushMatrix();
+        gfxTranslatef(centerX, centerY, 0);
+        gfxScalef(pixelsPerUnit, pixelsPerUnit, 1);
+        if (sprite < SPRITE_KEY) {
+            drawCoinArt((sprite - SPRITE_COIN_FIRST) / (float)(COIN_FRAME_COUNT - 1), 24);
+        } else if (sprite == SPRITE_KEY) {
+            drawKeyArt();
+        } else if (sprite == SPRITE_SHIELD) {
+            drawShieldArt();
+        } else if (sprite == SPRITE_WINGS) {
+            drawWingsArt();
+        } else if (sprite == SPRITE_HEART_ICON) {
+            drawHeartIconArt(0, 0, 1);
+        } else if (sprite == SPRITE_COIN_ICON) {
+            drawCoinIconArt(0, 0, 1);
+        } else {
+            drawKeyIconArt(-2.5f, 0, 1); // Centre the icon's -6.5..11 span
+        }
+        gfxPopMatrix();
+        
+        cursorX += cell;
+        shelfHeight = std::max(shelfHeight, cell);
+    }
+    gfxFlush();
+    
+    // A face-on coin must be opaque at its centre; without destination alpha
+    // (or if the copy can't work) keep drawing the primitives instead
+    GLubyte centre[4] = {0, 0, 0, 0};
+    const AtlasRegion& coin = atlas.regions[SPRITE_COIN_FIRST + COIN_FRAME_COUNT - 1];
+    glReadPixels((int)((coin.u0 + coin.u1) * 0.5f * atlasWidth), (int)((coin.v0 + coin.v1) * 0.5f * atlasHeight),
+                 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, centre);
+    if (fits && centre[3] == 255) {
+        glGenTextures(1, &atlas.texture);
+        glBindTexture(GL_TEXTURE_2D, atlas.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, atlasWidth, atlasHeight, 0);
+    } else {
+        std::cerr << "Sprite atlas unavailable, drawing pickups from primitives" << std::endl;
+    }
+    
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    reshape(glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+}
+
+// Parse a "--name=value" multiplier option
+bool parseFactorOption(const std::string& arg, const char* name, float& out) {
+    std::string prefix = std::string(name) + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    out = std::max(0.01f, std::min(1000.0f, (float)atof(arg.c_str() + prefix.size())));
+    return true;
+}
+
+// Parse game options (GLUT's own single-dash options are left for glutInit)
+void parseCommandLine(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        float factor;
+        if (arg == "--stress") {
+            stress.enabled = true;
+            stress.rockRate = stress.platforms = stress.coins = stress.particles = 10.0f;
+        } else if (parseFactorOption(arg, "--stress", factor)) {
+            stress.enabled = true;
+            stress.rockRate = stress.platforms = stress.coins = stress.particles = factor;
+        } else if (parseFactorOption(arg, "--stress-rocks", stress.rockRate) ||
+                   parseFactorOption(arg, "--stress-platforms", stress.platforms) ||
+                   parseFactorOption(arg, "--stress-coins", stress.coins) ||
+                   parseFactorOption(arg, "--stress-particles", stress.particles)) {
+            stress.enabled = true;
+        } else if (arg.compare(0, 10, "--quality=") == 0) {
+            quality.level = std::max(0, std::min(QUALITY_LEVEL_COUNT - 1, atoi(arg.c_str() + 10)));
+            quality.pinned = true;
+        } else if (arg.compare(0, 15, "--frame-budget=") == 0) {
+            quality.budgetMs = std::max(1.0, atof(arg.c_str() + 15));
+        } else if (arg == "--renderer=core") {
+            renderBackend = RENDER_CORE;
+        } else if (arg == "--renderer=legacy") {
+            renderBackend = RENDER_LEGACY;
+        } else if (arg == "--no-atlas") {
+            atlas.enabled = false;
+        } else if (arg == "--no-menu-cache") {
+            menuCacheEnabled = false;
+        } else if (arg == "--profile") {
+            profiler.overlayVisible = true;
+        } else if (arg == "--no-sim-thread") {
+            simulation.enabled = false;
+        } else if (arg == "--fixed-pacing") {
+            frameScheduler.fixedPacing = true;
+        } else if (arg == "--report-latency") {
+            profiler.latencyReport = true;
+        } else if (arg.compare(0, 17, "--validate-seeds=") == 0) {
+            seedValidation.seedCount = std::max(1, atoi(arg.c_str() + 17));
+        } else if (arg.compare(0, 18, "--build-seed-bank=") == 0) {
+            seedBankBuild.path = arg.substr(18);
+        } else if (arg.compare(0, 8, "--seeds=") == 0) {
+            seedBankBuild.seedCount = std::max(1, atoi(arg.c_str() + 8));
+        } else if (arg.compare(0, 8, "--level=") == 0) {
+            std::string choice = arg.substr(8);
+            bankedLevel.enabled = true;
+            bankedLevel.byRank = choice == "easy" || choice == "medium" || choice == "hard";
+            bankedLevel.difficulty = choice == "easy" ? 0.1f : choice == "medium" ? 0.5f : choice == "hard" ? 0.9f
+                                   : std::max(0.0f, std::min(1.0f, (float)atof(choice.c_str())));
+        } else if (arg.compare(0, 12, "--seed-bank=") == 0) {
+            bankedLevel.bankPath = arg.substr(12);
+        } else if (arg.compare(0, 21, "--check-fast-forward=") == 0) {
+            fastForwardCheck.runs = std::max(1, atoi(arg.c_str() + 21));
+        } else if (arg.compare(0, 19, "--check-tick-rates=") == 0) {
+            tickRateCheck.runs = std::max(1, atoi(arg.c_str() + 19));
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            seedValidation.threads = std::max(1, atoi(arg.c_str() + 10));
+        } else if (arg == "--help") {
+            std::cout << "Usage: IcyTower [options]\n"
+                      << "  --stress[=N]             Multiply rocks, platforms, coins and particles by N (default 10)\n"
+                      << "  --stress-rocks=N         Multiply rock spawn rate by N\n"
+                      << "  --stress-platforms=N     Multiply platform count by N\n"
+                      << "  --stress-coins=N         Multiply coin count by N\n"
+                      << "  --stress-particles=N     Multiply background particle count by N\n"
+                      << "  --profile                Show the profiler overlay (toggle in game with F3)\n"
+                      << "  --renderer=core|legacy   GL 3.3 core-profile shader renderer, or fixed-function GL (default)\n"
+                      << "  --no-menu-cache          Redraw menu panels every frame instead of replaying a display list\n"
+                      << "  --no-atlas               Draw pickups and HUD icons from primitives instead of the sprite atlas\n"
+                      << "  --quality=N              Pin decoration detail (0 = full ... 3 = minimum); default is adaptive\n"
+                      << "  --no-sim-thread          Run physics from the frame timer instead of its own thread\n"
+                      << "  --fixed-pacing           Redraw on a plain 16 ms timer instead of the adaptive frame scheduler\n"
+                      << "  --report-latency         Print input-to-simulation and input-to-swap latency every two seconds\n"
+                      << "  --frame-budget=MS        CPU time per frame before adaptive quality steps down (default 12)\n"
+                      << "  --validate-seeds=N       Generate seeds 0..N-1 without a window and report climbability stats\n"
+                      << "  --threads=T              Threads for the task scheduler, including the one waiting on it (default: all;\n"
+                      << "                           the game always keeps one worker)\n"
+                      << "  --build-seed-bank=PATH   Generate, validate and score --seeds=N levels (default 20000) into a bank\n"
+                      << "  --level=easy|medium|hard Play the banked level at the 10th/50th/90th difficulty percentile\n"
+                      << "  --level=D                Play the banked level nearest difficulty score D (0..1)\n"
+                      << "  --seed-bank=PATH         Seed bank for --level (default: levels.bank next to the executable)\n"
+                      << "  --check-fast-forward=N   Play N scripted runs stepped and fast-forwarded and compare the results\n"
+                      << "  --check-tick-rates=N     Play N scripted runs at 10, 30, 60 and 144 Hz and compare the trajectories\n";
+            exit(0);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown option: " << arg << " (see --help)" << std::endl;
+        }
+    }
+    
+    if (stress.enabled) {
+        profiler.overlayVisible = true;
+        std::cerr << "Stress mode: rocks x" << stress.rockRate << ", platforms x" << stress.platforms
+                  << ", coins x" << stress.coins << ", particles x" << stress.particles << std::endl;
+    }
+}
+
+// Create the window with a context for the selected renderer; if the core
+// renderer can't start, recreate the window with a legacy context
+void createGameWindow() {
+    const char* title = "Icy Tower - Computer Graphics Assignment";
+    if (renderBackend == RENDER_CORE) {
+        unsigned int mode = GLUT_DOUBLE | GLUT_RGBA | GLUT_ALPHA;
+#ifdef FREEGLUT
+        glutInitContextVersion(3, 3);
+        glutInitContextProfile(GLUT_CORE_PROFILE);
+#elif defined(GLUT_3_2_CORE_PROFILE)
+        mode |= GLUT_3_2_CORE_PROFILE; // macOS: a 3.2+ core context (4.1 in practice)
+#endif
+        glutInitDisplayMode(mode);
+        int window = glutCreateWindow(title);
+        if (initCoreRenderer()) return;
+        
+        std::cerr << "Core renderer unavailable, falling back to legacy GL" << std::endl;
+        glutDestroyWindow(window);
+        renderBackend = RENDER_LEGACY;
+#ifdef FREEGLUT
+        glutInitContextVersion(1, 0);
+        glutInitContextProfile(GLUT_COMPATIBILITY_PROFILE);
+#endif
+    }
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_ALPHA); // Destination alpha for the sprite atlas
+    glutCreateWindow(title);
+}
+
 int main(int argc, char** argv) {
+    parseCommandLine(argc, argv);
+    
+    // A thread waiting on tasks runs them too, so the pool leaves one of the threads
+    // for it. Nothing waits on the game's asset loads and level refills, so it
+    // keeps a worker even with --threads=1
+    int threads = seedValidation.threads > 0 ? seedValidation.threads : (int)std::thread::hardware_concurrency();
+    bool headless = seedValidation.seedCount > 0 || !seedBankBuild.path.empty() || fastForwardCheck.runs > 0 ||
+                    tickRateCheck.runs > 0;
+    tasks.start(headless ? std::max(0, threads - 1) : std::max(1, threads - 1));
+    
+    if (seedValidation.seedCount > 0) return runSeedValidation();
+    if (!seedBankBuild.path.empty()) return buildSeedBank();
+    if (fastForwardCheck.runs > 0) return runFastForwardCheck();
+    if (tickRateCheck.runs > 0) return runTickRateCheck();
     glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA); // RGBA for alpha blending
     glutInitWindowSize(WIDTH, HEIGHT);
-    glutCreateWindow("Icy Tower - Computer Graphics Assignment");
+    initLavaStrip(); // Before the window: the core renderer uploads it at startup
+    createGameWindow();
     
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Black background
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    // Load logo texture
-    logoTexture = loadTexture("IcyTowerLogo.png", &logoWidth, &logoHeight);
-    if (logoTexture == 0) {
-        std::cerr << "Warning: Failed to load logo texture. Using fallback." << std::endl;
-    }
+    // Decode the logo and read the sounds in the background; the menu draws the
+    // pixel-art logo until the texture is uploaded
+    startAssetLoading(argv[0]);
+    
+    if (atlas.enabled) initSpriteAtlas();
     
+    loadBankedLevel();
+    startLevelPool();
     initGame();
+    startSimulationThread();
+    initAmbientParticles();
     
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
@@ -3010,7 +6825,9 @@ int main(int argc, char** argv) {
     glutKeyboardUpFunc(keyboardUp);
     glutSpecialFunc(specialKey);
     glutSpecialUpFunc(specialKeyUp);
-    glutTimerFunc(0, timer, 0);
+    glutVisibilityFunc(visibility);
+    glutEntryFunc(entry);
+    glutTimerFunc(0, timer, frameScheduler.generation);
     
     glutMainLoop();
     return 0;
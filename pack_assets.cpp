@@ -0,0 +1,114 @@
+// Build-time asset packer: pack_assets [--source] <output> <input>...
+// PNG inputs are decoded to RGBA8 here so the game never decodes them;
+// everything else is stored byte for byte. See asset_pack.h for the layout.
+// With --source the archive is written as a C++ file defining
+// embeddedAssetPack/embeddedAssetPackSize, to be compiled into the game.
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <iterator>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "asset_pack.h"
+
+// File name without its directory
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool hasSuffix(const std::string& text, const char* suffix) {
+    size_t n = strlen(suffix);
+    return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    bool asSource = argc > 1 && strcmp(argv[1], "--source") == 0;
+    int first = asSource ? 2 : 1;
+    if (argc < first + 2) {
+        std::cerr << "Usage: pack_assets [--source] <output> <input>..." << std::endl;
+        return 1;
+    }
+    const char* outputPath = argv[first];
+
+    std::vector<PackEntry> entries;
+    std::vector<std::vector<unsigned char>> payloads;
+    for (int i = first + 1; i < argc; i++) {
+        std::string path = argv[i];
+        std::string name = baseName(path);
+        PackEntry entry = {};
+        if (name.size() >= sizeof(entry.name)) {
+            std::cerr << "pack_assets: name too long: " << name << std::endl;
+            return 1;
+        }
+        memcpy(entry.name, name.c_str(), name.size() + 1);
+
+        std::vector<unsigned char> payload;
+        if (hasSuffix(name, ".png")) {
+            int width, height, channels;
+            unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+            if (!pixels) {
+                std::cerr << "pack_assets: failed to decode " << path << std::endl;
+                return 1;
+            }
+            payload.assign(pixels, pixels + (size_t)width * height * 4);
+            stbi_image_free(pixels);
+            entry.kind = PACK_RGBA8;
+            entry.width = width;
+            entry.height = height;
+        } else {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                std::cerr << "pack_assets: failed to read " << path << std::endl;
+                return 1;
+            }
+            payload.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            entry.kind = PACK_SOUND;
+        }
+        entry.size = payload.size();
+        entries.push_back(entry);
+        payloads.push_back(std::move(payload));
+    }
+
+    // Assign aligned offsets after the index
+    uint64_t offset = sizeof(PackHeader) + entries.size() * sizeof(PackEntry);
+    for (PackEntry& entry : entries) {
+        offset = (offset + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+        entry.offset = offset;
+        offset += entry.size;
+    }
+
+    PackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = entries.size();
+
+    // Assemble the archive (padding bytes stay zero)
+    std::vector<unsigned char> archive(offset, 0);
+    memcpy(archive.data(), &header, sizeof(header));
+    memcpy(archive.data() + sizeof(header), entries.data(), entries.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < entries.size(); i++) {
+        memcpy(archive.data() + entries[i].offset, payloads[i].data(), payloads[i].size());
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (asSource) {
+        // Aligned like a mapping would be, so entry views keep their alignment
+        out << "// Generated by pack_assets; do not edit.\n#include <cstddef>\n\n"
+            << "alignas(" << PACK_ALIGNMENT << ") extern const unsigned char embeddedAssetPack[] = {";
+        for (size_t i = 0; i < archive.size(); i++) {
+            out << (i % 24 == 0 ? "\n" : "") << (unsigned)archive[i] << ',';
+        }
+        out << "\n};\nextern const size_t embeddedAssetPackSize = " << archive.size() << ";\n";
+    } else {
+        out.write((const char*)archive.data(), archive.size());
+    }
+    if (!out) {
+        std::cerr << "pack_assets: failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
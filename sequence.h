@@ -0,0 +1,144 @@
+// Coroutine sequences: scripted game events and asynchronous loads written as
+// straight-line code instead of flags and timers spread across the update.
+//
+// Calling a Sequence function runs it up to its first co_await; the returned
+// Sequence owns the suspended coroutine and destroys it with itself. Frames come
+// from a fixed pool, so starting a sequence mid-game doesn't touch the heap.
+// SequenceRunner resumes only the sequences that asked for the next tick; a
+// sequence waiting on anything else (an asset load, say) is resumed by whatever
+// completes it and costs the runner nothing while it waits.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed blocks for coroutine frames, claimed with a lock-free bitmask so the
+// simulation and GL threads can both start sequences
+class SequenceFramePool {
+public:
+    static const size_t BLOCK_SIZE = 512;
+    static const int BLOCK_COUNT = 32;
+
+    void* allocate(size_t size) {
+        if (size <= BLOCK_SIZE) {
+            uint32_t used = inUse.load(std::memory_order_relaxed);
+            while (used != UINT32_MAX) {
+                uint32_t bit = 1u << std::countr_one(used);
+                if (inUse.compare_exchange_weak(used, used | bit, std::memory_order_acquire)) {
+                    return blocks[std::countr_zero(bit)];
+                }
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void release(void* frame) {
+        unsigned char* bytes = (unsigned char*)frame;
+        if (bytes >= blocks[0] && bytes < blocks[0] + sizeof(blocks)) {
+            int index = (int)((bytes - blocks[0]) / BLOCK_SIZE);
+            inUse.fetch_and(~(1u << index), std::memory_order_release);
+        } else {
+            ::operator delete(frame);
+        }
+    }
+
+private:
+    static_assert(BLOCK_COUNT == 32, "inUse holds one bit per block");
+    alignas(std::max_align_t) unsigned char blocks[BLOCK_COUNT][BLOCK_SIZE];
+    std::atomic<uint32_t> inUse{0};
+};
+
+inline SequenceFramePool sequenceFrames;
+
+class [[nodiscard]] Sequence {
+public:
+    struct promise_type {
+        static void* operator new(size_t size) { return sequenceFrames.allocate(size); }
+        static void operator delete(void* frame) { sequenceFrames.release(frame); }
+
+        Sequence get_return_object() { return Sequence(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; } // Owner sees done() and frees it
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Sequence() = default;
+    Sequence(Sequence&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Sequence& operator=(Sequence&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Sequence() { reset(); }
+
+    bool done() const { return !handle || handle.done(); }
+
+    // Destroy the coroutine wherever it is suspended
+    void reset() {
+        if (handle) handle.destroy();
+        handle = nullptr;
+    }
+
+private:
+    explicit Sequence(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Resumes sequences once per simulation tick. Lists keep their capacity, so a
+// steady game doesn't allocate here either
+class SequenceRunner {
+public:
+    SequenceRunner() {
+        running.reserve(16);
+        waiting.reserve(16);
+        resuming.reserve(16);
+    }
+
+    // Awaitable: resume on the next tick, yielding that tick's length in seconds
+    struct NextTick {
+        SequenceRunner& runner;
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> sequence) { runner.waiting.push_back(sequence); }
+        float await_resume() const { return runner.tickSeconds; }
+    };
+
+    NextTick nextTick() { return {*this}; }
+
+    // Keep a sequence alive until it finishes or clear() is called
+    void start(Sequence sequence) {
+        if (!sequence.done()) running.push_back(std::move(sequence));
+    }
+
+    void tick(float deltaTime) {
+        if (waiting.empty()) return;
+        tickSeconds = deltaTime;
+        resuming.swap(waiting); // Anything that awaits again lands in waiting for the next tick
+        for (std::coroutine_handle<> sequence : resuming) sequence.resume();
+        resuming.clear();
+        running.erase(std::remove_if(running.begin(), running.end(),
+                                     [](const Sequence& s) { return s.done(); }), running.end());
+    }
+
+    // Destroy every sequence, finished or not (new game)
+    void clear() {
+        waiting.clear();
+        running.clear();
+    }
+
+private:
+    std::vector<Sequence> running;                  // Owned, possibly suspended elsewhere
+    std::vector<std::coroutine_handle<>> waiting;   // Suspended on nextTick()
+    std::vector<std::coroutine_handle<>> resuming;
+    float tickSeconds = 0.0f;
+};
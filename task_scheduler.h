@@ -0,0 +1,232 @@
+// Work-stealing task scheduler shared by the game's subsystems.
+//
+// Each worker thread owns a deque. It pushes and pops its own tasks at the back,
+// newest first, and when it runs dry it steals the oldest task from the front of
+// another worker's deque. Threads outside the pool (main(), the GLUT thread, the
+// simulation thread) submit to a shared queue. A thread waiting on a TaskGroup
+// runs that group's queued tasks meanwhile, and those of groups waited on inside
+// them, so a task can spawn children and wait for them without holding up a
+// worker. It never picks up unrelated work: a frame waiting on particles can't
+// end up generating a level.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Counts the unfinished tasks spawned into it
+struct TaskGroup {
+    std::atomic<int> pending{0};
+    TaskGroup* parent = nullptr; // Group of the task that waits on this one, if any
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Totals since start()
+struct TaskStats {
+    long long tasksRun = 0;
+    long long steals = 0;   // Tasks taken from another worker's deque
+    double idleMs = 0.0;    // Worker time spent asleep waiting for work, summed over workers
+};
+
+class TaskScheduler {
+public:
+    // Start the workers; they run until the process exits
+    void start(int workerCount) {
+        for (int i = 0; i < workerCount; i++) workers.push_back(std::make_unique<Worker>());
+        for (int i = 0; i < workerCount; i++) std::thread(&TaskScheduler::workerLoop, this, i).detach();
+    }
+
+    int workerCount() const { return (int)workers.size(); }
+
+    // Queue fn to run on any thread; group, if given, counts it until it has finished
+    void spawn(std::function<void()> fn, TaskGroup* group = nullptr) {
+        if (group) group->pending.fetch_add(1, std::memory_order_relaxed);
+        if (currentWorker >= 0) {
+            Worker& worker = *workers[currentWorker];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back({std::move(fn), group});
+        } else {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            shared.push_back({std::move(fn), group});
+        }
+        queued.fetch_add(1);
+        if (sleeping.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wakeUp.notify_one();
+        }
+    }
+
+    // Run the group's queued tasks until every task in it has finished. With none
+    // left to take it spins a little, then sleeps until some group finishes; the
+    // timeout picks up tasks the group's running ones spawn meanwhile
+    void wait(TaskGroup& group) {
+        int idleRounds = 0;
+        while (!group.done()) {
+            Task task;
+            if (findTask(task, &group)) {
+                run(task);
+                idleRounds = 0;
+            } else if (++idleRounds < 64) {
+                std::this_thread::yield();
+            } else {
+                blockedWaiters.fetch_add(1);
+                std::unique_lock<std::mutex> lock(groupMutex);
+                if (!group.done()) groupDone.wait_for(lock, std::chrono::milliseconds(1));
+                lock.unlock();
+                blockedWaiters.fetch_sub(1);
+            }
+        }
+    }
+
+    // Call body(first, last) over [begin, end) in pieces of at most grain items and
+    // wait for all of them. Ranges are halved recursively so idle workers steal
+    // large pieces first
+    template <typename Body>
+    void parallelFor(int begin, int end, int grain, const Body& body) {
+        TaskGroup group;
+        group.parent = runningGroup;
+        splitRange(begin, end, std::max(1, grain), body, group);
+        wait(group);
+    }
+
+    TaskStats stats() const {
+        TaskStats total;
+        total.tasksRun = externalTasksRun.load(std::memory_order_relaxed);
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            total.tasksRun += worker->tasksRun.load(std::memory_order_relaxed);
+            total.steals += worker->steals.load(std::memory_order_relaxed);
+            total.idleMs += worker->idleMicros.load(std::memory_order_relaxed) / 1000.0;
+        }
+        return total;
+    }
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<long long> tasksRun{0}, steals{0}, idleMicros{0};
+    };
+
+    template <typename Body>
+    void splitRange(int begin, int end, int grain, const Body& body, TaskGroup& group) {
+        while (end - begin > grain) {
+            int middle = begin + (end - begin) / 2;
+            spawn([this, middle, end, grain, &body, &group] { splitRange(middle, end, grain, body, group); }, &group);
+            end = middle;
+        }
+        if (begin < end) body(begin, end);
+    }
+
+    void workerLoop(int index) {
+        currentWorker = index;
+        Worker& self = *workers[index];
+        while (true) {
+            Task task;
+            if (findTask(task, nullptr)) {
+                run(task);
+                continue;
+            }
+            // Sleep until a spawn; queued is checked under the lock spawn() notifies with
+            auto start = std::chrono::steady_clock::now();
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleeping.fetch_add(1);
+                wakeUp.wait(lock, [this] { return queued.load() > 0; });
+                sleeping.fetch_sub(1);
+            }
+            self.idleMicros.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        }
+    }
+
+    // Own deque (newest first), then the shared queue, then the other workers (oldest
+    // first). A waiter only takes tasks of the group it waits on (see belongsTo)
+    bool findTask(Task& task, const TaskGroup* waited) {
+        if (queued.load(std::memory_order_relaxed) == 0) return false;
+        if (currentWorker >= 0 && takeFrom(workers[currentWorker]->mutex, workers[currentWorker]->tasks, task, false, waited)) {
+            return true;
+        }
+        if (takeFrom(sharedMutex, shared, task, true, waited)) return true;
+        int count = (int)workers.size();
+        int first = currentWorker >= 0 ? currentWorker + 1 : 0;
+        for (int i = 0; i < count; i++) {
+            int victim = (first + i) % count;
+            if (victim == currentWorker) continue;
+            if (takeFrom(workers[victim]->mutex, workers[victim]->tasks, task, true, waited)) {
+                if (currentWorker >= 0) workers[currentWorker]->steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether a task of `group` helps finish `waited`: it's in it, or in a group
+    // waited on by one of its tasks. Any task does for a worker that isn't waiting
+    static bool belongsTo(const TaskGroup* group, const TaskGroup* waited) {
+        if (!waited) return true;
+        for (; group; group = group->parent) {
+            if (group == waited) return true;
+        }
+        return false;
+    }
+
+    bool takeFrom(std::mutex& mutex, std::deque<Task>& tasks, Task& task, bool oldest, const TaskGroup* waited) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto take = [&](std::deque<Task>::iterator it) {
+            task = std::move(*it);
+            tasks.erase(it);
+            queued.fetch_sub(1);
+            return true;
+        };
+        if (oldest) {
+            for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+                if (belongsTo(it->group, waited)) return take(it);
+            }
+        } else {
+            for (auto it = tasks.end(); it != tasks.begin();) {
+                if (belongsTo((--it)->group, waited)) return take(it);
+            }
+        }
+        return false;
+    }
+
+    void run(Task& task) {
+        TaskGroup* outer = std::exchange(runningGroup, task.group);
+        task.fn();
+        runningGroup = outer;
+        if (currentWorker >= 0) workers[currentWorker]->tasksRun.fetch_add(1, std::memory_order_relaxed);
+        else externalTasksRun.fetch_add(1, std::memory_order_relaxed);
+        // The group may be gone once its count hits 0, so only the scheduler is touched after
+        if (task.group && task.group->pending.fetch_sub(1) == 1 && blockedWaiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(groupMutex);
+            groupDone.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers; // Fixed once start() returns
+    std::mutex sharedMutex;
+    std::deque<Task> shared;                      // Spawned from threads outside the pool
+    std::atomic<long long> queued{0};             // Tasks waiting in any queue
+    std::atomic<long long> externalTasksRun{0};   // Run by waiting threads outside the pool
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> sleeping{0};
+    std::mutex groupMutex;
+    std::condition_variable groupDone;            // A group's last task finished
+    std::atomic<int> blockedWaiters{0};           // Threads asleep in wait()
+    static inline thread_local int currentWorker = -1; // This thread's worker index, -1 outside the pool
+    static inline thread_local TaskGroup* runningGroup = nullptr; // Group of the task this thread is running
+};